@@ -0,0 +1,178 @@
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/receiver_concepts.hpp>
+
+#include "timer_queue.hpp"
+
+/*
+ * ASYNC DELAY - WAITING WITHOUT A WORKER
+ *
+ * std::this_thread::sleep_for() inside a task keeps a pool thread busy for
+ * the whole wait, so a pool of N threads overlaps at most N waits. delay()
+ * is a sender that completes after the given duration instead: starting it
+ * only registers a timer on TimerQueue::shared(), and the worker that
+ * started it returns to the pool at once.
+ *
+ *     auto fetch = unifex::schedule(pool.get_scheduler())
+ *         | unifex::let_value([] { return dag::delay(std::chrono::milliseconds(50)); })
+ *         | unifex::then([] { return read_reply(); });
+ *
+ * A 4-thread pool can thus keep hundreds of simulated (or real) I/O waits in
+ * flight; the waits cost one heap entry each, not one thread each.
+ *
+ * - the sender completes with set_value() on the timer thread, so whatever
+ *   follows it runs there too; keep that short, or hop back to a pool with
+ *   unifex::schedule(),
+ * - a stop request on the receiver's stop token (unifex::get_stop_token())
+ *   cancels the timer and completes the sender with set_done() right away,
+ *   e.g. when a pipeline fails, a node misses its deadline or an enclosing
+ *   unifex algorithm stops its children. Async nodes of a GraphExecutor
+ *   pass the node's stop token this way.
+ *
+ * Whichever of the timer and the stop request claims the operation first
+ * completes it, and deregisters the stop callback before completing the
+ * receiver: the receiver may destroy the operation from inside set_value(),
+ * on the timer thread, while another thread is requesting stop.
+ */
+
+namespace dag {
+
+template<typename Receiver>
+class DelayOperation {
+private:
+    struct State;
+
+    struct StopCallback {
+        State* state;
+
+        void operator()() noexcept {
+            State* const claimed = state;  // *this is destroyed by finish()
+            TimerQueue::TimerId timer;
+            {
+                std::lock_guard<std::mutex> lock(claimed->mutex);
+                if (claimed->completed) {
+                    return;
+                }
+                claimed->stop_requested = true;
+                if (claimed->timer == 0) {
+                    return;  // not started yet: start() sees stop_requested
+                }
+                claimed->completed = true;
+                timer = claimed->timer;
+            }
+            // Never waits for a timer already firing: that callback finds the
+            // operation completed and leaves it alone
+            TimerQueue::shared().try_cancel(timer);
+            claimed->finish(true);
+        }
+    };
+
+    using StopToken = unifex::stop_token_type_t<Receiver&>;
+    using StopCallbackFor = typename StopToken::template callback_type<StopCallback>;
+
+    // Shared with the timer callback, which may outlive the operation by the
+    // few instructions it takes it to lose the race
+    struct State {
+        std::mutex mutex;
+        bool completed = false;
+        bool stop_requested = false;
+        TimerQueue::TimerId timer = 0;
+        Receiver receiver;
+        std::optional<StopCallbackFor> stop_callback;
+
+        explicit State(Receiver&& r) : receiver(std::move(r)) {}
+
+        bool claim() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (completed) {
+                return false;
+            }
+            completed = true;
+            return true;
+        }
+
+        // Only after claim(). Deregistering waits for a stop callback running
+        // on another thread, which is never waiting for this one in turn.
+        void finish(bool stopped) noexcept {
+            stop_callback.reset();
+            if (stopped) {
+                unifex::set_done(std::move(receiver));
+            } else {
+                unifex::set_value(std::move(receiver));
+            }
+        }
+    };
+
+    TimerQueue::Clock::duration delay_;
+    std::shared_ptr<State> state_;
+
+public:
+    DelayOperation(TimerQueue::Clock::duration delay, Receiver&& receiver)
+        : delay_(delay)
+        , state_(std::make_shared<State>(std::move(receiver))) {}
+
+    DelayOperation(const DelayOperation&) = delete;
+    DelayOperation& operator=(const DelayOperation&) = delete;
+
+    void start() noexcept {
+        // Registered before the timer exists, so a stop request is never missed
+        auto stop_token = unifex::get_stop_token(state_->receiver);
+        if (stop_token.stop_possible()) {
+            state_->stop_callback.emplace(stop_token, StopCallback{state_.get()});
+        }
+
+        bool stopped;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            stopped = state_->stop_requested;
+            if (!stopped) {
+                state_->timer = TimerQueue::shared().schedule_after(delay_, [state = state_]() {
+                    if (state->claim()) {
+                        state->finish(false);
+                    }
+                });
+            }
+        }
+        if (stopped && state_->claim()) {
+            state_->finish(true);
+        }
+    }
+};
+
+class DelaySender {
+private:
+    TimerQueue::Clock::duration delay_;
+
+public:
+    template<template<typename...> class Variant, template<typename...> class Tuple>
+    using value_types = Variant<Tuple<>>;
+
+    template<template<typename...> class Variant>
+    using error_types = Variant<>;
+
+    static constexpr bool sends_done = true;
+
+    explicit DelaySender(TimerQueue::Clock::duration delay) : delay_(delay) {}
+
+    template<typename Receiver>
+    DelayOperation<std::remove_cv_t<std::remove_reference_t<Receiver>>> connect(Receiver&& receiver) const {
+        return DelayOperation<std::remove_cv_t<std::remove_reference_t<Receiver>>>(
+            delay_, std::forward<Receiver>(receiver));
+    }
+};
+
+// Sender that completes `duration` from when it is started
+template<typename Rep, typename Period>
+DelaySender delay(std::chrono::duration<Rep, Period> duration) {
+    return DelaySender(std::chrono::duration_cast<TimerQueue::Clock::duration>(duration));
+}
+
+} // namespace dag
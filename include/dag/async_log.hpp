@@ -0,0 +1,390 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * ASYNC LOG - PRINTING WITHOUT STALLING WORKERS
+ *
+ * `std::cout << ... << std::endl` from a pool thread takes the stream lock
+ * and flushes on every line, so logging workers queue behind each other and
+ * behind the terminal. log_line() instead copies its arguments into a slot of
+ * the calling thread's ring buffer and returns; a background drain thread
+ * formats the lines and writes them to the sink in batches, one flush per
+ * batch. The drain thread sleeps on a condition variable while the rings are
+ * empty and the first line pushed after that wakes it, so an idle log costs
+ * nothing and a busy one costs a producer no more than the push:
+ *
+ *     dag::log_line("  [Task1] done on thread ", std::this_thread::get_id());
+ *     ...
+ *     dag::flush_log();   // before printing on std::cout directly again
+ *
+ * - every thread gets its own single-producer/single-consumer ring in each
+ *   AsyncLog on first use, so producers never contend with each other or
+ *   with the drain thread; the only shared write is one fetch_add on the
+ *   log's line counter,
+ * - formatting is deferred: operator<< runs on the drain thread, the worker
+ *   only copies the arguments. Character arrays (string literals among them)
+ *   are copied into the slot itself and other C strings into a std::string,
+ *   so a line never points at a buffer that is gone by the time it is
+ *   written. Arguments that do not fit a slot are formatted on the spot,
+ * - lines come out in the order log_line() was called, across all threads,
+ *   so a line logged after another (in happens-before order) is printed
+ *   after it,
+ * - a full ring makes its producer yield until the drain thread catches up;
+ *   nothing is dropped,
+ * - flush_log() returns once every line logged before it has been written;
+ *   call it before writing to the sink directly, e.g. on the main thread
+ *   after a run, so the two outputs do not interleave.
+ *
+ * Do not log from static destructors; the drain thread is stopped, after a
+ * final drain, when the program exits.
+ */
+
+namespace dag {
+
+namespace log_detail {
+
+// A character array copied into the slot. A string literal and a local
+// buffer have the same type, and the buffer may be gone (or reused) by the
+// time the line is written, so neither is kept by pointer
+template<std::size_t N>
+struct chars {
+    char text[N];
+
+    chars(const char (&source)[N]) {
+        std::memcpy(text, source, N);
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const chars& value) {
+        const std::size_t length = std::find(value.text, value.text + N, '\0') - value.text;
+        return out << std::string_view(value.text, length);
+    }
+};
+
+// Arguments as stored in a ring slot. A character pointer may dangle by the
+// time the line is written (e.what(), a buffer), so its string is copied...
+template<typename T>
+struct stored {
+    using type = std::conditional_t<std::is_same_v<std::decay_t<T>, const char*> ||
+                                        std::is_same_v<std::decay_t<T>, char*>,
+                                    std::string, std::decay_t<T>>;
+};
+
+// ...and so is an array, but in place, without allocating
+template<std::size_t N>
+struct stored<const char (&)[N]> {
+    using type = chars<N>;
+};
+
+template<std::size_t N>
+struct stored<char (&)[N]> {
+    using type = chars<N>;
+};
+
+template<typename T>
+using stored_t = typename stored<T>::type;
+
+} // namespace log_detail
+
+class AsyncLog {
+private:
+    static constexpr std::size_t kRingSlots = 1024;
+    static constexpr std::size_t kPayloadBytes = 224;
+
+    struct Record {
+        std::uint64_t sequence;
+        void (*write)(std::ostream&, void*);
+        void (*destroy)(void*);
+        alignas(std::max_align_t) unsigned char payload[kPayloadBytes];
+    };
+
+    // Written by its thread, read by the drain thread
+    class Ring {
+    private:
+        Record slots_[kRingSlots];
+        alignas(64) std::atomic<std::uint64_t> head_{0};  // next slot to drain
+        alignas(64) std::atomic<std::uint64_t> tail_{0};  // next slot to fill
+
+    public:
+        std::atomic<bool> orphaned{false};  // its thread has exited
+        std::atomic<bool> closed{false};    // its AsyncLog has been destroyed
+
+        template<typename Fill>
+        bool try_push(Fill&& fill) {
+            const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) == kRingSlots) {
+                return false;
+            }
+            fill(slots_[tail % kRingSlots]);
+            tail_.store(tail + 1, std::memory_order_seq_cst);  // ordered before wake()'s idle_ load
+            return true;
+        }
+
+        template<typename Consume>
+        void drain(Consume&& consume) {
+            std::uint64_t head = head_.load(std::memory_order_relaxed);
+            const std::uint64_t tail = tail_.load(std::memory_order_acquire);
+            for (; head != tail; ++head) {
+                Record& record = slots_[head % kRingSlots];
+                consume(record);
+                record.destroy(record.payload);
+            }
+            head_.store(head, std::memory_order_release);
+        }
+
+        bool empty() const {
+            return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_seq_cst);
+        }
+    };
+
+    // A thread's rings, one per AsyncLog it has logged to, keyed by the
+    // log's serial so that a log allocated where a destroyed one used to be
+    // does not pick up its ring. Marks them orphaned when the thread exits;
+    // the drain threads still write what is left in them
+    struct ThreadRings {
+        std::uint64_t serial = 0;  // of the log `last` belongs to
+        Ring* last = nullptr;
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<Ring>>> rings;
+
+        ~ThreadRings() {
+            for (auto& entry : rings) {
+                entry.second->orphaned.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    static std::uint64_t next_serial() {
+        static std::atomic<std::uint64_t> serial{0};
+        return serial.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    const std::uint64_t serial_ = next_serial();
+    alignas(64) std::atomic<std::uint64_t> next_sequence_{0};
+    std::atomic<bool> idle_{false};  // drain thread is waiting, or about to
+
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable flushed_cv_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::ostream* sink_ = &std::cout;
+    std::uint64_t written_ = 0;  // lines [0, written_) are on the sink
+    bool stopping_ = false;
+
+    // Drain-thread state: formatted lines waiting for an earlier sequence
+    // number still being pushed by another thread
+    std::map<std::uint64_t, std::string> pending_;
+    std::uint64_t next_to_write_ = 0;
+    std::ostringstream line_;
+    const std::ios blank_format_{nullptr};  // each line starts from default flags
+
+    std::thread thread_;  // last: loop() uses every member above
+
+    Ring& ring() {
+        thread_local ThreadRings local;
+        if (local.serial != serial_) {
+            auto it = std::find_if(local.rings.begin(), local.rings.end(),
+                                   [this](const auto& entry) { return entry.first == serial_; });
+            if (it == local.rings.end()) {
+                // Rings of destroyed logs are no longer drained by anyone
+                local.rings.erase(std::remove_if(local.rings.begin(), local.rings.end(), [](const auto& entry) {
+                                      return entry.second->closed.load(std::memory_order_acquire);
+                                  }), local.rings.end());
+                auto ring = std::make_shared<Ring>();
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    rings_.push_back(ring);
+                }
+                local.rings.emplace_back(serial_, std::move(ring));
+                it = std::prev(local.rings.end());
+            }
+            local.serial = serial_;
+            local.last = it->second.get();
+        }
+        return *local.last;
+    }
+
+    template<typename Payload>
+    void push(Payload&& payload) {
+        using Stored = std::decay_t<Payload>;
+        static_assert(sizeof(Stored) <= kPayloadBytes && alignof(Stored) <= alignof(std::max_align_t),
+                      "payload does not fit a ring slot");
+
+        Ring& local = ring();
+        const std::uint64_t sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+        auto fill = [&](Record& record) {
+            record.sequence = sequence;
+            record.write = [](std::ostream& out, void* storage) {
+                std::apply([&out](const auto&... args) { (out << ... << args); },
+                           *std::launder(reinterpret_cast<Stored*>(storage)));
+            };
+            record.destroy = [](void* storage) {
+                std::launder(reinterpret_cast<Stored*>(storage))->~Stored();
+            };
+            new (record.payload) Stored(std::forward<Payload>(payload));
+        };
+        while (!local.try_push(fill)) {
+            wake();
+            std::this_thread::yield();
+        }
+        wake();
+    }
+
+    // Called after a push. The tail_ store and idle_ load here and the idle_
+    // store and tail_ loads in loop() are all seq_cst, so either the drain
+    // thread sees the new line before it sleeps, or this sees it idle
+    void wake() {
+        if (idle_.load(std::memory_order_seq_cst) && idle_.exchange(false, std::memory_order_relaxed)) {
+            // Under the mutex, so the notify cannot fall between the drain
+            // thread checking idle_ and starting to wait
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_cv_.notify_one();
+        }
+    }
+
+    // One pass over every ring; returns true if anything was written
+    bool drain_once(bool final_pass) {
+        std::vector<std::shared_ptr<Ring>> rings;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rings = rings_;
+        }
+
+        for (auto& ring : rings) {
+            ring->drain([this](Record& record) {
+                line_.str(std::string());
+                line_.copyfmt(blank_format_);
+                record.write(line_, record.payload);
+                line_ << '\n';
+                pending_.emplace(record.sequence, line_.str());
+            });
+        }
+
+        std::ostream* sink;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sink = sink_;
+            rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring>& ring) {
+                             return ring->orphaned.load(std::memory_order_acquire) && ring->empty();
+                         }), rings_.end());
+        }
+
+        bool wrote = false;
+        auto next = pending_.begin();
+        while (next != pending_.end() && (final_pass || next->first == next_to_write_)) {
+            *sink << next->second;
+            next_to_write_ = next->first + 1;
+            next = pending_.erase(next);
+            wrote = true;
+        }
+        if (wrote) {
+            sink->flush();
+        }
+        return wrote;
+    }
+
+    bool rings_empty() const {
+        return std::all_of(rings_.begin(), rings_.end(),
+                           [](const std::shared_ptr<Ring>& ring) { return ring->empty(); });
+    }
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            lock.unlock();
+            drain_once(false);
+            lock.lock();
+            written_ = next_to_write_;
+            flushed_cv_.notify_all();
+
+            // Sleep only once every ring is empty; a line still on its way
+            // (or with an earlier sequence number than one held in pending_)
+            // wakes us through wake() when its push completes
+            idle_.store(true, std::memory_order_seq_cst);
+            if (rings_empty()) {
+                wake_cv_.wait(lock, [this] { return stopping_ || !idle_.load(std::memory_order_relaxed); });
+            }
+            idle_.store(false, std::memory_order_relaxed);
+        }
+        lock.unlock();
+        drain_once(true);
+    }
+
+public:
+    AsyncLog() : thread_([this] { loop(); }) {}
+
+    ~AsyncLog() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_cv_.notify_one();
+        thread_.join();
+        for (auto& ring : rings_) {
+            ring->closed.store(true, std::memory_order_release);
+        }
+    }
+
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    static AsyncLog& shared() {
+        static AsyncLog log;
+        return log;
+    }
+
+    // Writes the arguments, streamed one after another, followed by a newline
+    template<typename... Args>
+    void line(Args&&... args) {
+        using Stored = std::tuple<log_detail::stored_t<Args>...>;
+        if constexpr (sizeof(Stored) <= kPayloadBytes && alignof(Stored) <= alignof(std::max_align_t)) {
+            push(Stored(std::forward<Args>(args)...));
+        } else {
+            std::ostringstream formatted;
+            (formatted << ... << args);
+            push(std::tuple<std::string>(formatted.str()));
+        }
+    }
+
+    // Blocks until every line logged before the call is on the sink
+    void flush() {
+        const std::uint64_t target = next_sequence_.load(std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(mutex_);
+        flushed_cv_.wait(lock, [this, target] { return written_ >= target || stopping_; });
+    }
+
+    // Where drained lines go; std::cout by default
+    void set_sink(std::ostream& sink) {
+        flush();
+        std::lock_guard<std::mutex> lock(mutex_);
+        sink_ = &sink;
+    }
+};
+
+template<typename... Args>
+void log_line(Args&&... args) {
+    AsyncLog::shared().line(std::forward<Args>(args)...);
+}
+
+inline void flush_log() {
+    AsyncLog::shared().flush();
+}
+
+} // namespace dag
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/*
+ * CPU TOPOLOGY - WHERE WORKERS SHOULD RUN
+ *
+ * Reads the CPU and NUMA layout from sysfs, so it works on any Linux box
+ * without libnuma:
+ *
+ *     /sys/devices/system/cpu/online                       usable CPUs
+ *     /sys/devices/system/cpu/cpuN/topology/...            package, core, SMT siblings
+ *     /sys/devices/system/node/online, nodeN/cpulist       NUMA nodes
+ *
+ * and intersects it with the CPUs this process may run on (its affinity mask,
+ * e.g. as restricted by a container or taskset).
+ *
+ * placement_order() lists CPUs in the order workers should be put on them:
+ * node by node, so that a pool smaller than the machine stays on as few nodes
+ * as possible, and within a node one hardware thread of every core before
+ * any SMT sibling. pin_current_thread() binds the calling thread to one CPU.
+ *
+ * Without sysfs (or off Linux) every hardware thread is reported on node 0
+ * and pinning is a no-op that returns false.
+ */
+
+namespace dag {
+
+class CpuTopology {
+public:
+    struct Cpu {
+        int id = 0;
+        int node = 0;
+        int package = 0;
+        int core = 0;
+        int smt_rank = 0;  // position among the hyperthreads of its core
+    };
+
+private:
+    std::vector<Cpu> cpus_;  // sorted by id
+    std::size_t nodes_ = 1;
+
+    static std::optional<std::string> read_line(const std::string& path) {
+        std::ifstream in(path);
+        std::string line;
+        if (!in || !std::getline(in, line)) {
+            return std::nullopt;
+        }
+        return line;
+    }
+
+    static std::optional<int> read_int(const std::string& path) {
+        auto line = read_line(path);
+        if (!line) {
+            return std::nullopt;
+        }
+        try {
+            return std::stoi(*line);
+        } catch (...) {
+            return std::nullopt;
+        }
+    }
+
+    static std::vector<int> allowed_cpus() {
+        std::vector<int> allowed;
+#if defined(__linux__)
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &mask)) {
+                    allowed.push_back(cpu);
+                }
+            }
+        }
+#endif
+        return allowed;
+    }
+
+public:
+    // "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}; malformed parts are skipped
+    static std::vector<int> parse_cpu_list(const std::string& list) {
+        std::vector<int> cpus;
+        std::stringstream parts(list);
+        std::string part;
+        while (std::getline(parts, part, ',')) {
+            try {
+                const std::size_t dash = part.find('-');
+                const int first = std::stoi(part.substr(0, dash));
+                const int last = dash == std::string::npos ? first : std::stoi(part.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            } catch (...) {
+            }
+        }
+        std::sort(cpus.begin(), cpus.end());
+        cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+        return cpus;
+    }
+
+    static CpuTopology detect(const std::string& sys_root = "/sys/devices/system") {
+        CpuTopology topology;
+
+        std::vector<int> online;
+        if (auto list = read_line(sys_root + "/cpu/online")) {
+            online = parse_cpu_list(*list);
+        }
+        if (online.empty()) {
+            for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+                online.push_back(static_cast<int>(cpu));
+            }
+        }
+        const std::vector<int> allowed = allowed_cpus();
+        if (!allowed.empty()) {
+            std::vector<int> usable;
+            std::set_intersection(online.begin(), online.end(), allowed.begin(), allowed.end(),
+                                  std::back_inserter(usable));
+            if (!usable.empty()) {
+                online = std::move(usable);
+            }
+        }
+
+        std::map<int, int> node_of;
+        if (auto nodes = read_line(sys_root + "/node/online")) {
+            for (int node : parse_cpu_list(*nodes)) {
+                if (auto list = read_line(sys_root + "/node/node" + std::to_string(node) + "/cpulist")) {
+                    for (int cpu : parse_cpu_list(*list)) {
+                        node_of[cpu] = node;
+                    }
+                }
+            }
+        }
+
+        int max_node = 0;
+        for (int id : online) {
+            const std::string base = sys_root + "/cpu/cpu" + std::to_string(id) + "/topology/";
+            Cpu cpu;
+            cpu.id = id;
+            cpu.node = node_of.count(id) != 0 ? node_of[id] : 0;
+            cpu.package = read_int(base + "physical_package_id").value_or(0);
+            cpu.core = read_int(base + "core_id").value_or(id);
+            if (auto siblings = read_line(base + "thread_siblings_list")) {
+                const std::vector<int> list = parse_cpu_list(*siblings);
+                cpu.smt_rank = static_cast<int>(std::find(list.begin(), list.end(), id) - list.begin());
+                if (cpu.smt_rank == static_cast<int>(list.size())) {
+                    cpu.smt_rank = 0;
+                }
+            }
+            max_node = std::max(max_node, cpu.node);
+            topology.cpus_.push_back(cpu);
+        }
+        topology.nodes_ = static_cast<std::size_t>(max_node) + 1;
+        return topology;
+    }
+
+    const std::vector<Cpu>& cpus() const { return cpus_; }
+
+    // Highest node id + 1; nodes without usable CPUs count too
+    std::size_t node_count() const { return nodes_; }
+
+    int node_of(int cpu) const {
+        for (const Cpu& entry : cpus_) {
+            if (entry.id == cpu) {
+                return entry.node;
+            }
+        }
+        return 0;
+    }
+
+    // CPUs in the order workers should take them, restricted to `subset` if
+    // it is not empty (ids not in the topology are ignored)
+    std::vector<int> placement_order(const std::vector<int>& subset = {}) const {
+        std::vector<Cpu> chosen;
+        for (const Cpu& cpu : cpus_) {
+            if (subset.empty() || std::find(subset.begin(), subset.end(), cpu.id) != subset.end()) {
+                chosen.push_back(cpu);
+            }
+        }
+        std::sort(chosen.begin(), chosen.end(), [](const Cpu& a, const Cpu& b) {
+            return std::tie(a.node, a.smt_rank, a.package, a.core, a.id) <
+                   std::tie(b.node, b.smt_rank, b.package, b.core, b.id);
+        });
+        std::vector<int> order;
+        for (const Cpu& cpu : chosen) {
+            order.push_back(cpu.id);
+        }
+        return order;
+    }
+
+    // Binds the calling thread to `cpu`; false if that is not possible
+    static bool pin_current_thread(int cpu) {
+#if defined(__linux__)
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(cpu, &mask);
+        return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+};
+
+} // namespace dag
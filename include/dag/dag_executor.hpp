@@ -0,0 +1,1134 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <unifex/any_sender_of.hpp>
+#include <unifex/execute.hpp>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/inplace_stop_token.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/tag_invoke.hpp>
+
+#include "flat_graph.hpp"
+#include "graph_validation.hpp"
+#include "latency_histogram.hpp"
+#include "result_cache.hpp"
+#include "task_graph.hpp"
+#include "timer_queue.hpp"
+#include "trace_recorder.hpp"
+
+/*
+ * GRAPH EXECUTOR - DEPENDENCY-DRIVEN SCHEDULING
+ *
+ * Instead of running the graph level by level (with a barrier after every
+ * level), each node keeps a counter of predecessors that have not finished
+ * yet. When a node completes it decrements the counters of its successors and
+ * every successor whose counter reaches zero is handed to the scheduler right
+ * away, from the thread that finished the last dependency.
+ *
+ *     level barriers:   [T1 T2 T3]──barrier──[T4 T5]──barrier──[T6]
+ *     dependency-driven: T4 starts as soon as T1 and T2 are done,
+ *                        even while T3 is still running.
+ *
+ * When more nodes are ready than the pool has threads, the order in which they
+ * run matters. With DispatchPolicy::CriticalPath (the default) ready nodes
+ * are kept in a priority queue ordered by upward rank - the cost of the
+ * longest path from the node to the end of the graph - and every job handed
+ * to the scheduler picks the most critical ready node at the moment it
+ * actually starts running, regardless of the order the scheduler serves its
+ * own queue in. DispatchPolicy::Fifo hands nodes to the scheduler directly.
+ *
+ * The first exception thrown by a node stops further dispatching and requests
+ * stop on the run's inplace_stop_source. Nodes already queued are skipped
+ * when they reach a worker, and running nodes see NodeInputs::stop_token()
+ * signalled so they can bail out (throwing TaskCancelled) instead of
+ * finishing doomed work. run() returns once no node is running and rethrows
+ * the first exception.
+ *
+ * Per-run storage (node results, pending counters, ranks, ready queue) is
+ * owned by the executor and reused across runs, so repeated runs of the same
+ * graph do not allocate. The graph's shape is flattened once per graph into
+ * CSR arrays (FlatGraph) that completions walk; every pending counter has a
+ * cache line of its own, so workers finishing neighbouring nodes do not
+ * contend for one line; and ready nodes are pushed onto a lock-free list
+ * that the job about to pick a node drains into the priority queue. A graph
+ * changed since its last run (see TaskGraph::generation()) counts as a new
+ * graph. Node results live in a ResultArena that run() returns; it stays
+ * valid until the next run. One executor runs one graph at a time.
+ *
+ * With ResultRetention::ReleaseConsumed every node also counts the consumers
+ * (successors) that still have to finish; when the last one completes the
+ * node's value is destroyed, so memory follows the frontier of the run
+ * instead of the whole graph. Only the values of sink nodes survive the run.
+ * In that mode the last consumer of a value may also move it out of the arena
+ * with NodeInputs::take() instead of copying it - unless the consumer has a
+ * RetryPolicy, whose retries must see the same inputs as the first attempt.
+ *
+ * With a ResultCache attached (set_cache()), a node marked cacheable is looked
+ * up by (graph id, name, hash of its inputs) when it becomes ready. On a hit
+ * the cached value is copied into the arena and the node completes without
+ * being dispatched - through the same per-thread worklist as inline nodes
+ * (below), so a long chain of hits does not nest; on a miss it runs normally
+ * and its result is inserted.
+ *
+ * Incremental runs: after a successful run, invalidate() marks nodes whose
+ * external data changed and run_incremental() re-executes only the changed
+ * nodes and their downstream closure; every other node keeps its value from
+ * the previous run. For example, invalidating T3 re-runs T3 -> T5 -> T6 and
+ * leaves T1, T2 and T4 untouched. Requires ResultRetention::KeepAll. If the
+ * graph differs from the one last run - or was changed since - or that run
+ * failed, run_incremental() falls back to a full run. Invalidated nodes
+ * always execute, even when their cache key is present in the ResultCache,
+ * and their new result replaces the entry under that key.
+ *
+ * With a TraceRecorder attached (set_trace()), every executed node records
+ * when it became ready, when it started and finished, and on which thread;
+ * see TraceRecorder::write_chrome_trace(). With LatencyStats attached
+ * (set_latency_stats()), the same timestamps feed per-node queue-wait,
+ * run-time and end-to-end histograms that accumulate across runs.
+ *
+ * Deadlines are armed on TimerQueue::shared(), so no worker sleeps waiting
+ * for them:
+ *
+ * - a node with TaskGraph::set_timeout() gets a timer when it becomes ready.
+ *   Whichever comes first - the node returning or the timer firing - resolves
+ *   the node. On expiry the node's own stop token is signalled and, by its
+ *   TimeoutPolicy, the run fails with NodeTimeout or the successors proceed
+ *   with the default / last successful value while the node winds down;
+ *   whatever it returns afterwards is discarded,
+ * - ExecutorOptions::pipeline_deadline bounds a whole run: on expiry the run
+ *   fails with PipelineTimeout and every node is stopped.
+ *
+ * Either way run() returns only after every started node has returned, so
+ * long nodes must poll their stop token for deadlines to cut a run short.
+ *
+ * A node with a RetryPolicy (TaskGraph::set_retry()) that throws a retryable
+ * exception is re-dispatched after an exponential, jittered backoff. The
+ * backoff is a TimerQueue timer: the worker goes back to the pool and runs
+ * other ready nodes meanwhile. If the run fails during a backoff the pending
+ * retry is cancelled. Retries of a node with a deadline stop once the
+ * deadline has resolved it.
+ *
+ * An async node (TaskGraph::add_async_node()) returns a sender; the worker
+ * that starts it moves on right away, and the node completes - with the same
+ * caching, deadline, retry and failure handling - when the sender does, on
+ * whichever thread completes it. Waits inside such nodes (e.g. delay()) hold
+ * no worker, so a small pool keeps many of them in flight.
+ *
+ * Chain fusion (ExecutorOptions::fuse_chains, on by default): a node readied
+ * by a predecessor that has no other consumer - a link of a linear chain, or
+ * the join of single-consumer branches such as T4, T5 -> T6 - is not handed
+ * back to the scheduler. The job that ran the predecessor runs it next, on
+ * the same thread, so the edge costs a function call instead of a queue
+ * round-trip. Nodes readied from outside a job (by a timer) and every other
+ * successor are dispatched as usual; last_run_fused() counts the fused ones.
+ *
+ * Inline nodes skip the scheduler whatever the graph's shape: a node marked
+ * with TaskGraph::set_inline(), or - with ExecutorOptions::inline_below set -
+ * a synchronous node whose measured run time averages below that bound, runs
+ * as soon as it is ready, on the thread that readied it (a worker, the timer
+ * thread, or run()'s caller for a source). Inline nodes readied by one that
+ * runs this way go on a per-thread worklist drained in a loop, so a long
+ * chain of them does not grow the stack.
+ * Run times are measured per graph and kept across runs, so a node is
+ * classified from its second run on; last_run_inlined() counts such nodes.
+ *
+ * With ExecutorOptions::validate set, a graph is checked (see
+ * graph_validation.hpp) before its first run: run() throws
+ * GraphValidationError naming the problem instead of starting a graph whose
+ * nodes could never all become ready. last_validation() holds the report,
+ * shape statistics included.
+ */
+
+namespace dag {
+
+enum class DispatchPolicy {
+    Fifo,           // ready nodes run in the order they became ready
+    CriticalPath    // ready nodes run by decreasing upward rank
+};
+
+enum class ResultRetention {
+    KeepAll,         // every node's value is available after run()
+    ReleaseConsumed  // values are destroyed once all their consumers finished
+};
+
+struct ExecutorOptions {
+    DispatchPolicy policy = DispatchPolicy::CriticalPath;
+    ResultRetention retention = ResultRetention::KeepAll;
+    std::chrono::milliseconds pipeline_deadline{0};  // 0 = no deadline
+    bool fuse_chains = true;  // run single-consumer successors in the finishing job
+    std::chrono::nanoseconds inline_below{0};  // run nodes measured faster inline; 0 = off
+    bool validate = false;  // check each new graph before its first run
+};
+
+template<typename Value>
+class GraphExecutor {
+private:
+    struct ReadyEntry {
+        double rank;
+        NodeId id;
+
+        // Highest rank first; ties resolved in favour of the lower node id
+        bool operator<(const ReadyEntry& other) const {
+            return rank != other.rank ? rank < other.rank : id > other.id;
+        }
+    };
+
+    // Synchronisation state of a single run
+    struct RunState {
+        const TaskGraph<Value>& graph;
+
+        // Nodes handed to the scheduler that have not finished yet, plus
+        // armed node deadline timers
+        std::atomic<std::size_t> outstanding{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        unifex::inplace_stop_source stop_source;
+
+        std::mutex mutex;
+        std::condition_variable finished_cv;
+        bool finished = false;
+
+        std::int64_t start_ns = 0;  // set when timings are recorded
+
+        std::atomic<std::size_t> fused{0};
+        std::atomic<std::size_t> inlined{0};
+
+        explicit RunState(const TaskGraph<Value>& g) : graph(g) {}
+    };
+
+    struct alignas(64) PendingCounter {
+        std::atomic<std::uint32_t> value{0};
+    };
+
+    static constexpr NodeId kNoNode = ~NodeId(0);
+
+    ExecutorOptions options_;
+
+    // Reused across runs
+    ResultArena<Value> results_;
+    std::unique_ptr<PendingCounter[]> pending_;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> consumers_;
+    std::size_t counter_capacity_ = 0;
+    std::vector<NodeId> sources_;
+    // Cache key of every cacheable node readied this run; empty if it could
+    // not be computed (the run had failed), and then nothing is inserted
+    std::vector<std::optional<std::size_t>> input_hashes_;
+
+    // Incremental state: nodes executed by the current run, nodes invalidated
+    // since the last successful run, and the generation of the graph that
+    // run completed
+    std::vector<char> dirty_;
+    std::vector<char> changed_;
+    std::uint64_t completed_generation_ = 0;
+    std::size_t last_run_size_ = 0;
+
+    ResultCache<Value>* cache_ = nullptr;
+
+    TraceRecorder* trace_ = nullptr;
+    LatencyStats* latencies_ = nullptr;
+    std::vector<std::int64_t> enqueue_ns_;  // when each node became ready
+
+    bool timed() const { return trace_ != nullptr || latencies_ != nullptr; }
+
+    // Deadline state, only allocated for graphs with timed nodes, and only
+    // reallocated when a graph outgrows it. A node is resolved exactly once:
+    // by returning or by its timer, whichever claims it first. Each node gets
+    // its own stop source so a late node can be stopped without stopping the
+    // run; a stop source cannot be reset, so a signalled one is destroyed
+    // and constructed again in its slot before the next run.
+    std::unique_ptr<std::atomic<bool>[]> resolved_;
+    std::unique_ptr<std::optional<unifex::inplace_stop_source>[]> node_stop_;
+    std::size_t deadline_capacity_ = 0;
+    std::vector<TimerQueue::TimerId> timers_;
+    std::vector<std::optional<Value>> last_values_;  // for TimeoutPolicy::UseLastValue
+    std::uint64_t last_values_generation_ = 0;
+
+    bool claim(NodeId id) { return !resolved_[id].exchange(true, std::memory_order_acq_rel); }
+
+    // Retry state, only used for graphs with retried nodes: failed attempts
+    // per node (touched only by the node's own attempts, which never overlap)
+    // and the pending backoff timer of each node, 0 if none
+    std::vector<unsigned> attempts_;
+    std::mutex retry_mutex_;
+    std::vector<TimerQueue::TimerId> retry_timers_;
+
+    // Ready nodes are pushed onto an intrusive list without a lock; a job
+    // takes the whole list into the heap under ready_mutex_ before popping
+    std::atomic<NodeId> pushed_head_{kNoNode};
+    std::unique_ptr<NodeId[]> pushed_next_;
+    std::mutex ready_mutex_;
+    std::vector<ReadyEntry> ready_;  // binary max-heap
+
+    // The shape of the graph last run, flattened. Like every per-graph cache
+    // here it is keyed on TaskGraph::generation(), which no other graph - and
+    // no later version of the same one - shares; 0 is never a generation.
+    std::uint64_t flat_generation_ = 0;
+    FlatGraph flat_;
+
+    // The node a running job continues with instead of dispatching it. One
+    // per thread; the owner check keeps a job of another executor (or run)
+    // sharing the thread from picking it up.
+    struct Continuation {
+        const GraphExecutor* owner = nullptr;
+        const RunState* state = nullptr;
+        NodeId id = 0;
+        bool pending = false;
+    };
+
+    static Continuation& continuation() {
+        thread_local Continuation slot;
+        return slot;
+    }
+
+    // Nodes this thread runs - or, for cache hits, only completes - outside
+    // a job, in a loop rather than nested in the node that readied them. The
+    // owner check works as for Continuation; a loop of another executor (or
+    // run) nested in this one saves the owner and only drains the entries it
+    // pushed.
+    struct LocalNode {
+        NodeId id;
+        bool cached;  // its value is already in the arena
+    };
+
+    struct LocalWork {
+        const GraphExecutor* owner = nullptr;
+        const RunState* state = nullptr;
+        std::vector<LocalNode> nodes;
+    };
+
+    static LocalWork& local_work() {
+        thread_local LocalWork work;
+        return work;
+    }
+
+    std::size_t last_run_fused_ = 0;
+    std::size_t last_run_inlined_ = 0;
+
+    // Average run time of every synchronous node, -1 until it has run; only
+    // kept with ExecutorOptions::inline_below set. Written by the node's own
+    // job, read when the node is next readied.
+    std::uint64_t measured_generation_ = 0;
+    std::vector<std::int64_t> measured_ns_;
+
+    bool classify() const { return options_.inline_below.count() > 0; }
+
+    bool runs_inline(const TaskGraph<Value>& graph, NodeId id) const {
+        if (graph.node(id).run_inline) {
+            return true;
+        }
+        return classify() && measured_ns_[id] >= 0 && measured_ns_[id] < options_.inline_below.count();
+    }
+
+    GraphReport validation_;
+
+    // Runs on the freshly flattened shape; a graph that fails stays
+    // unflattened, so the next run checks it again
+    void validate(const TaskGraph<Value>& graph) {
+        validation_ = validate_shape(validation_detail::FlatGraphShape<Value>{flat_, graph});
+        if (!validation_.valid()) {
+            std::ostringstream message;
+            message << "graph failed validation:\n";
+            print_report(message, validation_, [&graph](NodeId id) { return graph.node(id).name; });
+            throw GraphValidationError(message.str());
+        }
+    }
+
+    // Ranks depend only on the graph, so they are computed once per graph
+    std::uint64_t ranked_generation_ = 0;
+    std::vector<double> ranks_;
+
+    void prepare(const TaskGraph<Value>& graph, bool incremental) {
+        const std::size_t n = graph.size();
+        if (n > counter_capacity_) {
+            pending_.reset(new PendingCounter[n]);
+            consumers_.reset(new std::atomic<std::uint32_t>[n]);
+            pushed_next_.reset(new NodeId[n]);
+            counter_capacity_ = n;
+        }
+        // Like the ranks, the shape is rebuilt when the graph changes
+        if (flat_generation_ != graph.generation()) {
+            flat_generation_ = 0;
+            flat_.build(graph);
+            if (options_.validate) {
+                validate(graph);
+            }
+            flat_generation_ = graph.generation();
+        }
+
+        // Ids are in topological order, so one forward pass finds the
+        // downstream closure of the changed nodes
+        changed_.resize(n, 0);
+        dirty_.assign(n, incremental ? 0 : 1);
+        if (incremental) {
+            for (NodeId id = 0; id < n; ++id) {
+                bool dirty = changed_[id] != 0;
+                for (auto preds = flat_.predecessors(id); preds.first != preds.second; ++preds.first) {
+                    dirty = dirty || dirty_[*preds.first] != 0;
+                }
+                dirty_[id] = dirty ? 1 : 0;
+            }
+        }
+
+        sources_.clear();
+        last_run_size_ = 0;
+        for (NodeId id = 0; id < n; ++id) {
+            if (!dirty_[id]) {
+                continue;
+            }
+            std::uint32_t in_degree = flat_.in_degree(id);
+            if (incremental) {
+                in_degree = 0;
+                for (auto preds = flat_.predecessors(id); preds.first != preds.second; ++preds.first) {
+                    in_degree += dirty_[*preds.first] ? 1 : 0;
+                }
+            }
+            pending_[id].value.store(in_degree, std::memory_order_relaxed);
+            consumers_[id].store(flat_.out_degree(id), std::memory_order_relaxed);
+            if (in_degree == 0) {
+                sources_.push_back(id);
+            }
+            ++last_run_size_;
+        }
+
+        // An incremental run keeps the previous values of clean nodes
+        if (!incremental) {
+            results_.resize(n);
+        }
+        if (cache_ != nullptr) {
+            input_hashes_.resize(n);
+        }
+        if (timed()) {
+            enqueue_ns_.resize(n);
+        }
+        if (latencies_ != nullptr) {
+            latencies_->resize(n);
+        }
+        if (graph.has_timeouts()) {
+            if (n > deadline_capacity_) {
+                resolved_.reset(new std::atomic<bool>[n]);
+                node_stop_.reset(new std::optional<unifex::inplace_stop_source>[n]);
+                deadline_capacity_ = n;
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                resolved_[i].store(false, std::memory_order_relaxed);
+                // No callbacks are left registered between runs
+                if (!node_stop_[i] || node_stop_[i]->stop_requested()) {
+                    node_stop_[i].emplace();
+                }
+            }
+            timers_.resize(n);
+            if (last_values_generation_ != graph.generation()) {
+                last_values_.clear();
+                last_values_.resize(n);
+                last_values_generation_ = graph.generation();
+            }
+        }
+        if (graph.has_retries()) {
+            attempts_.assign(n, 0);
+            retry_timers_.assign(n, 0);
+        } else {
+            retry_timers_.clear();
+        }
+
+        if (classify() && measured_generation_ != graph.generation()) {
+            measured_ns_.assign(n, -1);
+            measured_generation_ = graph.generation();
+        }
+
+        if (options_.policy == DispatchPolicy::CriticalPath) {
+            if (ranked_generation_ != graph.generation()) {
+                ranks_ = graph.upward_ranks();
+                ranked_generation_ = graph.generation();
+            }
+            ready_.clear();
+            ready_.reserve(n);
+            pushed_head_.store(kNoNode, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    explicit GraphExecutor(ExecutorOptions options = {})
+        : options_(options) {}
+
+    explicit GraphExecutor(DispatchPolicy policy)
+        : GraphExecutor(ExecutorOptions{policy, ResultRetention::KeepAll}) {}
+
+    DispatchPolicy policy() const { return options_.policy; }
+    const ExecutorOptions& options() const { return options_; }
+
+    // Memoizes cacheable nodes in `cache` (not owned); nullptr disables caching
+    void set_cache(ResultCache<Value>* cache) { cache_ = cache; }
+    ResultCache<Value>* cache() const { return cache_; }
+
+    // Records a timeline of every run into `recorder` (not owned); nullptr
+    // disables tracing
+    void set_trace(TraceRecorder* recorder) { trace_ = recorder; }
+    TraceRecorder* trace() const { return trace_; }
+
+    // Accumulates per-node latency histograms into `stats` (not owned);
+    // nullptr disables them
+    void set_latency_stats(LatencyStats* stats) { latencies_ = stats; }
+    LatencyStats* latency_stats() const { return latencies_; }
+
+    // Executes every node of the graph on the given scheduler and blocks until
+    // the graph has finished. The returned arena holds the nodes' values,
+    // indexed by id, until the next call to run().
+    template<typename Scheduler>
+    const ResultArena<Value>& run(const TaskGraph<Value>& graph, Scheduler scheduler) {
+        return execute(graph, scheduler, false);
+    }
+
+    // Marks a node whose external inputs changed; the next run_incremental()
+    // re-executes it and everything downstream of it
+    void invalidate(NodeId id) {
+        if (id >= changed_.size()) {
+            changed_.resize(id + 1, 0);
+        }
+        changed_[id] = 1;
+    }
+
+    // Re-executes only the invalidated nodes and their downstream closure,
+    // reusing every other value from the previous run of the same graph
+    template<typename Scheduler>
+    const ResultArena<Value>& run_incremental(const TaskGraph<Value>& graph, Scheduler scheduler) {
+        if (options_.retention != ResultRetention::KeepAll) {
+            throw std::logic_error("Incremental runs need ResultRetention::KeepAll");
+        }
+        const bool incremental = completed_generation_ == graph.generation();
+        return execute(graph, scheduler, incremental);
+    }
+
+    // Number of nodes the last run executed (or completed from the cache)
+    std::size_t last_run_size() const { return last_run_size_; }
+
+    // Of those, the nodes run by their predecessor's job instead of being
+    // dispatched (see fuse_chains)
+    std::size_t last_run_fused() const { return last_run_fused_; }
+
+    // Nodes the last run executed inline (see set_inline() and inline_below)
+    std::size_t last_run_inlined() const { return last_run_inlined_; }
+
+    // Report of the last graph checked (see ExecutorOptions::validate)
+    const GraphReport& last_validation() const { return validation_; }
+
+    const ResultArena<Value>& results() const { return results_; }
+
+private:
+    template<typename Scheduler>
+    const ResultArena<Value>& execute(const TaskGraph<Value>& graph, Scheduler scheduler, bool incremental) {
+        completed_generation_ = 0;
+        last_run_fused_ = 0;
+        last_run_inlined_ = 0;
+        prepare(graph, incremental);
+        if (sources_.empty()) {
+            finish_run(graph);
+            return results_;
+        }
+
+        RunState state(graph);
+        if (timed()) {
+            state.start_ns = steady_clock_ns();
+        }
+        if (latencies_ != nullptr) {
+            latencies_->count_run();
+        }
+
+        TimerQueue::TimerId pipeline_timer = 0;
+        if (options_.pipeline_deadline.count() > 0) {
+            pipeline_timer = TimerQueue::shared().schedule_after(options_.pipeline_deadline, [this, &state]() {
+                {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    if (state.finished) {
+                        return;
+                    }
+                }
+                fail(state, std::make_exception_ptr(PipelineTimeout(options_.pipeline_deadline)));
+            });
+        }
+
+        state.outstanding.store(sources_.size(), std::memory_order_relaxed);
+        for (NodeId id : sources_) {
+            make_ready(state, scheduler, id);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            state.finished_cv.wait(lock, [&state] { return state.finished; });
+        }
+        if (pipeline_timer != 0) {
+            TimerQueue::shared().cancel(pipeline_timer);
+        }
+        last_run_fused_ = state.fused.load(std::memory_order_relaxed);
+        last_run_inlined_ = state.inlined.load(std::memory_order_relaxed);
+
+        if (state.error) {
+            std::rethrow_exception(state.error);
+        }
+        finish_run(graph);
+        return results_;
+    }
+
+    void finish_run(const TaskGraph<Value>& graph) {
+        std::fill(changed_.begin(), changed_.end(), 0);
+        completed_generation_ = graph.generation();
+    }
+
+    // Completes a node from the cache if possible, otherwise dispatches it -
+    // or, if `fusable` or an inline node, leaves it to the current job
+    template<typename Scheduler>
+    void make_ready(RunState& state, const Scheduler& scheduler, NodeId id, bool fusable = false) {
+        const auto& node = state.graph.node(id);
+        if (timed()) {
+            enqueue_ns_[id] = steady_clock_ns();
+        }
+        if (cache_ != nullptr && node.cacheable) {
+            input_hashes_[id].reset();
+            if (!state.failed.load(std::memory_order_acquire)) {
+                std::size_t input_hash = 0;
+                for (NodeId pred : node.predecessors) {
+                    input_hash = cache_->combine(input_hash, results_[pred]);
+                }
+                input_hashes_[id] = input_hash;
+
+                // A changed node is hashed but not looked up: its inputs may be
+                // the same while its external state is not. Its new result
+                // replaces the stale entry under the same key.
+                std::optional<Value> cached = changed_[id] ? std::optional<Value>()
+                                                           : cache_->find(CacheKey{state.graph.id(), node.name, input_hash});
+                if (cached) {
+                    results_.emplace(id, std::move(*cached));
+                    if (timed()) {
+                        record_timing(state, id, enqueue_ns_[id], enqueue_ns_[id], true);
+                    }
+                    run_locally(state, scheduler, id, true);
+                    return;
+                }
+            }
+        }
+        if (node.timeout.count() > 0) {
+            arm_deadline(state, scheduler, id);
+        }
+        const bool cheap = runs_inline(state.graph, id);
+        if ((fusable || cheap) && continue_with(state, id)) {
+            (cheap ? state.inlined : state.fused).fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (cheap) {
+            // Not in a job of this run (or its slot is taken): run it on this
+            // thread, without a job, so nothing else gets fused onto it
+            state.inlined.fetch_add(1, std::memory_order_relaxed);
+            run_locally(state, scheduler, id);
+            return;
+        }
+        dispatch(state, scheduler, id);
+    }
+
+    // Runs `id` on this thread, or only completes it if `cached`. If a loop
+    // of this run is already draining the thread's LocalWork - `id` was
+    // readied by a node it handles - `id` is appended to it; otherwise this
+    // call is that loop.
+    template<typename Scheduler>
+    void run_locally(RunState& state, const Scheduler& scheduler, NodeId id, bool cached = false) {
+        LocalWork& work = local_work();
+        work.nodes.push_back(LocalNode{id, cached});
+        if (work.owner == this && work.state == &state) {
+            return;
+        }
+        const GraphExecutor* outer_owner = work.owner;
+        const RunState* outer_state = work.state;
+        const std::size_t base = work.nodes.size() - 1;
+        work.owner = this;
+        work.state = &state;
+        while (work.nodes.size() > base) {
+            const LocalNode next = work.nodes.back();
+            work.nodes.pop_back();
+            if (next.cached) {
+                complete_node(state, scheduler, next.id);
+            } else {
+                run_node(state, scheduler, next.id);
+            }
+        }
+        work.owner = outer_owner;
+        work.state = outer_state;
+    }
+
+    // Hands `id` to the job running on this thread, if it belongs to this run
+    // and has no continuation yet
+    bool continue_with(RunState& state, NodeId id) {
+        Continuation& slot = continuation();
+        if (slot.owner != this || slot.state != &state || slot.pending) {
+            return false;
+        }
+        slot.id = id;
+        slot.pending = true;
+        return true;
+    }
+
+    // Body of every scheduler job: runs `id`, then the chain of nodes fused
+    // behind it. The slot is saved and restored because a scheduler that runs
+    // jobs inline (unifex::inline_scheduler) nests them.
+    template<typename Scheduler>
+    void run_job(RunState& state, const Scheduler& scheduler, NodeId id) {
+        Continuation& slot = continuation();
+        const Continuation outer = slot;
+        slot = Continuation{this, &state, 0, false};
+        for (;;) {
+            run_node(state, scheduler, id);
+            if (!slot.pending) {
+                break;
+            }
+            slot.pending = false;
+            id = slot.id;
+        }
+        slot = outer;
+    }
+
+    template<typename Scheduler>
+    void dispatch(RunState& state, const Scheduler& scheduler, NodeId id) {
+        if (options_.policy == DispatchPolicy::Fifo) {
+            unifex::execute(scheduler, [this, &state, scheduler, id]() {
+                run_job(state, scheduler, id);
+            });
+            return;
+        }
+
+        // One scheduler job per ready node; which node a job runs is decided
+        // when it starts, so late-arriving critical nodes overtake queued ones.
+        // A node is on the pushed list at most once: it is only pushed again
+        // (retried) after a job has taken it out and run it.
+        NodeId head = pushed_head_.load(std::memory_order_relaxed);
+        do {
+            pushed_next_[id] = head;
+        } while (!pushed_head_.compare_exchange_weak(head, id, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+        unifex::execute(scheduler, [this, &state, scheduler]() {
+            NodeId next;
+            {
+                std::lock_guard<std::mutex> lock(ready_mutex_);
+                // This job's own push is either in the heap or on the list
+                for (NodeId pushed = pushed_head_.exchange(kNoNode, std::memory_order_acquire);
+                     pushed != kNoNode; pushed = pushed_next_[pushed]) {
+                    ready_.push_back(ReadyEntry{ranks_[pushed], pushed});
+                    std::push_heap(ready_.begin(), ready_.end());
+                }
+                std::pop_heap(ready_.begin(), ready_.end());
+                next = ready_.back().id;
+                ready_.pop_back();
+            }
+            run_job(state, scheduler, next);
+        });
+    }
+
+    template<typename Scheduler>
+    void run_node(RunState& state, const Scheduler& scheduler, NodeId id) {
+        const auto& node = state.graph.node(id);
+        const bool timed_node = node.timeout.count() > 0;
+
+        // The run failed, or the timer already resolved the node: skip the work
+        if (state.failed.load(std::memory_order_acquire) ||
+            (timed_node && resolved_[id].load(std::memory_order_acquire))) {
+            if (!timed_node || claim(id)) {
+                if (timed_node) {
+                    disarm_deadline(state, id);
+                }
+                complete_node(state, scheduler, id);
+            } else {
+                abandon_node(state, id);
+            }
+            return;
+        }
+
+        const bool measured = classify() && !node.async_fn;
+        AttemptStart start;
+        if (timed() || measured) {
+            start.ns = steady_clock_ns();
+        }
+        if (trace_ != nullptr) {
+            start.thread = trace_->current_thread();
+        }
+        // A node that may be retried copies what it takes: a failed attempt
+        // must leave its inputs intact for the next one
+        const std::atomic<std::uint32_t>* remaining_consumers =
+            options_.retention == ResultRetention::ReleaseConsumed && node.retry.max_attempts <= 1 ? consumers_.get()
+                                                                                                : nullptr;
+        NodeInputs<Value> inputs(node.predecessors, results_, remaining_consumers,
+                                 timed_node ? node_stop_[id]->get_token() : state.stop_source.get_token());
+
+        if (node.async_fn) {
+            start_async_node(state, scheduler, id, start, std::move(inputs));
+            return;
+        }
+
+        std::optional<Value> value;
+        std::exception_ptr error;
+        try {
+            value.emplace(node.fn(inputs));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        if (measured) {
+            // Moving average over runs, so one slow run does not flip the class
+            const std::int64_t took = steady_clock_ns() - start.ns;
+            std::int64_t& average = measured_ns_[id];
+            average = average < 0 ? took : (3 * average + took) / 4;
+        }
+        settle_node(state, scheduler, id, start, value, std::move(error));
+    }
+
+    // When an attempt started, and on which trace row (TraceRecorder::
+    // current_thread()): an async attempt finishes on whichever thread
+    // completes its sender, but belongs to the worker that started it
+    struct AttemptStart {
+        std::int64_t ns = 0;
+        std::uint32_t thread = 0;
+    };
+
+    // One attempt of an async node: owns the node's inputs and the operation
+    // of the sender its function returned
+    template<typename Scheduler>
+    struct AsyncAttempt;
+
+    template<typename Scheduler>
+    struct AsyncReceiver {
+        AsyncAttempt<Scheduler>* attempt;
+
+        void set_value(Value value) && noexcept {
+            std::optional<Value> result(std::move(value));
+            attempt->finish(result, nullptr);
+        }
+        void set_error(std::exception_ptr error) && noexcept {
+            std::optional<Value> result;
+            attempt->finish(result, std::move(error));
+        }
+        void set_done() && noexcept {
+            std::optional<Value> result;
+            attempt->finish(result, std::make_exception_ptr(TaskCancelled()));
+        }
+
+        // The node's stop token, so senders such as delay() stop with the node
+        friend unifex::inplace_stop_token tag_invoke(unifex::tag_t<unifex::get_stop_token>,
+                                                     const AsyncReceiver& receiver) noexcept {
+            return receiver.attempt->inputs.stop_token();
+        }
+    };
+
+    template<typename Scheduler>
+    struct AsyncAttempt {
+        using Operation = unifex::connect_result_t<unifex::any_sender_of<Value>, AsyncReceiver<Scheduler>>;
+
+        GraphExecutor& executor;
+        RunState& state;
+        Scheduler scheduler;
+        NodeId id;
+        AttemptStart start;
+        NodeInputs<Value> inputs;
+        Operation operation;
+        std::atomic<int> parties{2};  // unifex::start() and the completion
+
+        AsyncAttempt(GraphExecutor& executor_, RunState& state_, const Scheduler& scheduler_, NodeId id_,
+                     AttemptStart start_, NodeInputs<Value>&& inputs_)
+            : executor(executor_)
+            , state(state_)
+            , scheduler(scheduler_)
+            , id(id_)
+            , start(start_)
+            , inputs(std::move(inputs_))
+            , operation(unifex::connect(state_.graph.node(id_).async_fn(inputs), AsyncReceiver<Scheduler>{this})) {}
+
+        void finish(std::optional<Value>& value, std::exception_ptr error) noexcept {
+            executor.settle_node(state, scheduler, id, start, value, std::move(error));
+            release();
+        }
+
+        // Called once by start_async_node() after unifex::start() returns and
+        // once at the end of the completion, which may run inside start()
+        // (a sender that completes synchronously) or on another thread while
+        // start() is still returning. Whichever is last deletes the attempt;
+        // until then it holds the run open (one extra outstanding count).
+        void release() noexcept {
+            if (parties.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                GraphExecutor& owner = executor;
+                RunState& run = state;
+                delete this;
+                owner.retire(run);
+            }
+        }
+    };
+
+    template<typename Scheduler>
+    void start_async_node(RunState& state, const Scheduler& scheduler, NodeId id, AttemptStart start,
+                          NodeInputs<Value>&& inputs) {
+        AsyncAttempt<Scheduler>* attempt;
+        try {
+            attempt = new AsyncAttempt<Scheduler>(*this, state, scheduler, id, start, std::move(inputs));
+        } catch (...) {
+            // The node function threw before returning a sender
+            std::optional<Value> none;
+            settle_node(state, scheduler, id, start, none, std::current_exception());
+            return;
+        }
+        state.outstanding.fetch_add(1, std::memory_order_relaxed);
+        unifex::start(attempt->operation);
+        attempt->release();
+    }
+
+    // Records the outcome of one attempt of a node - its value, or the error
+    // it failed with - and completes, retries or abandons the node. A node
+    // with a deadline races its timer: whichever claims it first resolves it.
+    template<typename Scheduler>
+    void settle_node(RunState& state, const Scheduler& scheduler, NodeId id, AttemptStart start,
+                     std::optional<Value>& value, std::exception_ptr error) {
+        const auto& node = state.graph.node(id);
+        const bool timed_node = node.timeout.count() > 0;
+
+        // Before a retry is scheduled: the retry's dispatch rewrites enqueue_ns_
+        if (timed()) {
+            record_timing(state, id, start.ns, steady_clock_ns(), false, start.thread);
+        }
+
+        bool resolved_here = false;
+        bool retrying = false;
+        if (value) {
+            if (!timed_node || claim(id)) {
+                resolved_here = true;
+                if (timed_node) {
+                    disarm_deadline(state, id);
+                    if (node.on_timeout == TimeoutPolicy::UseLastValue) {
+                        last_values_[id].emplace(*value);
+                    }
+                }
+                const Value& result = results_.emplace(id, std::move(*value));
+                if (cache_ != nullptr && node.cacheable && input_hashes_[id]) {
+                    cache_->insert(CacheKey{state.graph.id(), node.name, *input_hashes_[id]}, result);
+                }
+            }
+        } else {
+            // Errors of a node that already timed out are expected (it was
+            // stopped) and dropped
+            if (!timed_node || !resolved_[id].load(std::memory_order_acquire)) {
+                retrying = schedule_retry(state, scheduler, id, error);
+            }
+            if (!retrying && (!timed_node || claim(id))) {
+                resolved_here = true;
+                if (timed_node) {
+                    disarm_deadline(state, id);
+                }
+                fail(state, std::move(error));
+            }
+        }
+
+        // A retried node stays outstanding until its next attempt completes
+        if (retrying) {
+            return;
+        }
+        if (resolved_here) {
+            complete_node(state, scheduler, id);
+            return;
+        }
+        abandon_node(state, id);
+    }
+
+    // The timer resolved the node and readied its successors; only the
+    // inputs the abandoned attempt was reading remain to be released
+    void abandon_node(RunState& state, NodeId id) {
+        if (!state.failed.load(std::memory_order_acquire) &&
+            options_.retention == ResultRetention::ReleaseConsumed) {
+            release_inputs(id);
+        }
+        retire(state);
+    }
+
+    // Re-dispatches a failed node after its backoff if its RetryPolicy allows
+    template<typename Scheduler>
+    bool schedule_retry(RunState& state, const Scheduler& scheduler, NodeId id, const std::exception_ptr& error) {
+        const RetryPolicy& retry = state.graph.node(id).retry;
+        if (retry.max_attempts <= 1 || state.failed.load(std::memory_order_acquire)) {
+            return false;
+        }
+        const unsigned failures = ++attempts_[id];
+        if (failures >= retry.max_attempts) {
+            return false;
+        }
+        const bool retryable = retry.retryable ? retry.retryable(error) : !retry_on<TaskCancelled>()(error);
+        if (!retryable) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(retry_mutex_);
+        retry_timers_[id] = TimerQueue::shared().schedule_after(backoff(retry, failures), [this, &state, scheduler, id]() {
+            {
+                std::lock_guard<std::mutex> lock(retry_mutex_);
+                retry_timers_[id] = 0;
+            }
+            if (timed()) {
+                enqueue_ns_[id] = steady_clock_ns();
+            }
+            dispatch(state, scheduler, id);
+        });
+        return true;
+    }
+
+    static std::chrono::nanoseconds backoff(const RetryPolicy& retry, unsigned failures) {
+        double ms = static_cast<double>(retry.initial_backoff.count()) *
+                    std::pow(retry.multiplier, static_cast<double>(failures - 1));
+        ms = std::min(ms, static_cast<double>(retry.max_backoff.count()));
+        if (retry.jitter > 0.0) {
+            thread_local std::minstd_rand rng{std::random_device{}()};
+            std::uniform_real_distribution<double> spread(-retry.jitter, retry.jitter);
+            ms *= 1.0 + spread(rng);
+        }
+        return std::chrono::nanoseconds(static_cast<std::int64_t>(std::max(ms, 0.0) * 1e6));
+    }
+
+    template<typename Scheduler>
+    void arm_deadline(RunState& state, const Scheduler& scheduler, NodeId id) {
+        state.outstanding.fetch_add(1, std::memory_order_relaxed);
+        timers_[id] = TimerQueue::shared().schedule_after(state.graph.node(id).timeout, [this, &state, scheduler, id]() {
+            on_deadline(state, scheduler, id);
+            retire(state);
+        });
+    }
+
+    // Called once the node is resolved by returning
+    void disarm_deadline(RunState& state, NodeId id) {
+        if (TimerQueue::shared().cancel(timers_[id])) {
+            retire(state);
+        }
+    }
+
+    template<typename Scheduler>
+    void on_deadline(RunState& state, const Scheduler& scheduler, NodeId id) {
+        if (!claim(id)) {
+            return;
+        }
+        const auto& node = state.graph.node(id);
+        node_stop_[id]->request_stop();
+        if (state.failed.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        const std::optional<Value>* fallback = nullptr;
+        if (node.on_timeout == TimeoutPolicy::UseDefault) {
+            fallback = &node.timeout_value;
+        } else if (node.on_timeout == TimeoutPolicy::UseLastValue) {
+            fallback = &last_values_[id];
+        }
+        if (fallback == nullptr || !fallback->has_value()) {
+            fail(state, std::make_exception_ptr(NodeTimeout(node.name, node.timeout)));
+            return;
+        }
+
+        results_.emplace(id, **fallback);
+        ready_successors(state, scheduler, id);
+    }
+
+    // Releases consumed inputs, readies successors and retires the node
+    template<typename Scheduler>
+    void complete_node(RunState& state, const Scheduler& scheduler, NodeId id) {
+        if (!state.failed.load(std::memory_order_acquire)) {
+            if (options_.retention == ResultRetention::ReleaseConsumed) {
+                release_inputs(id);
+            }
+            ready_successors(state, scheduler, id);
+        }
+        retire(state);
+    }
+
+    template<typename Scheduler>
+    void ready_successors(RunState& state, const Scheduler& scheduler, NodeId id) {
+        const bool single_consumer = options_.fuse_chains && flat_.out_degree(id) == 1;
+        for (auto succs = flat_.successors(id); succs.first != succs.second; ++succs.first) {
+            const NodeId succ = *succs.first;
+            if (!dirty_[succ]) {
+                continue;
+            }
+            if (pending_[succ].value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                state.outstanding.fetch_add(1, std::memory_order_relaxed);
+                make_ready(state, scheduler, succ, single_consumer);
+            }
+        }
+    }
+
+    void retire(RunState& state) {
+        if (state.outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.finished = true;
+            state.finished_cv.notify_all();
+        }
+    }
+
+    // Keeps the first error and stops every node of the run
+    void fail(RunState& state, std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (!state.error) {
+                state.error = std::move(error);
+            }
+        }
+        state.failed.store(true, std::memory_order_release);
+        state.stop_source.request_stop();
+        if (state.graph.has_timeouts()) {
+            for (std::size_t i = 0; i < state.graph.size(); ++i) {
+                node_stop_[i]->request_stop();
+            }
+        }
+
+        // Nodes waiting out a backoff will not be retried; a timer that is
+        // already firing re-dispatches its node, which then sees the failure
+        std::vector<TimerQueue::TimerId> pending;
+        {
+            std::lock_guard<std::mutex> lock(retry_mutex_);
+            for (auto& timer : retry_timers_) {
+                if (timer != 0) {
+                    pending.push_back(timer);
+                    timer = 0;
+                }
+            }
+        }
+        for (TimerQueue::TimerId timer : pending) {
+            if (TimerQueue::shared().cancel(timer)) {
+                retire(state);
+            }
+        }
+    }
+
+    // `thread` is the trace row the node ran on, by default the calling thread
+    void record_timing(const RunState& state, NodeId id, std::int64_t start_ns, std::int64_t end_ns, bool cached,
+                       std::uint32_t thread = TraceRecorder::kCallingThread) {
+        if (trace_ != nullptr) {
+            trace_->record(id, enqueue_ns_[id], start_ns, end_ns, cached, thread);
+        }
+        if (latencies_ != nullptr) {
+            NodeLatency& latency = latencies_->node(id);
+            if (!cached) {
+                latency.queue_wait.record(start_ns - enqueue_ns_[id]);
+                latency.run_time.record(end_ns - start_ns);
+            }
+            latency.end_to_end.record(end_ns - state.start_ns);
+        }
+    }
+
+    // Called once a consumer has finished reading its inputs
+    void release_inputs(NodeId id) {
+        for (auto preds = flat_.predecessors(id); preds.first != preds.second; ++preds.first) {
+            if (consumers_[*preds.first].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                results_.release(*preds.first);
+            }
+        }
+    }
+};
+
+} // namespace dag
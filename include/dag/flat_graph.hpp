@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "task_graph.hpp"
+
+/*
+ * FLAT GRAPH - THE SHAPE OF A TASK GRAPH AS ARRAYS
+ *
+ * TaskGraph keeps each node's predecessors and successors in vectors of their
+ * own, so walking the graph hops from one heap block to the next. FlatGraph
+ * copies the shape into compressed sparse rows, one array per field:
+ *
+ *     succ_offsets  [0, 2, 3, 4, 5, 5]      successors of node i are
+ *     succs         [3, 4, 4, 5, 5]          succs[succ_offsets[i] .. [i+1])
+ *     pred_offsets, preds                   the same for predecessors
+ *
+ * Degrees are differences of neighbouring offsets. The executor's hot loop -
+ * a node finishes, its successors' counters are decremented - then reads
+ * consecutive memory. Node payloads (functions, policies) stay in
+ * TaskGraph's contiguous node array and are reached by id.
+ *
+ * A FlatGraph is built once per graph and describes it until the graph is
+ * changed.
+ */
+
+namespace dag {
+
+class FlatGraph {
+public:
+    using Range = std::pair<const NodeId*, const NodeId*>;
+
+    template<typename Value>
+    void build(const TaskGraph<Value>& graph) {
+        const std::size_t n = graph.size();
+        succ_offsets_.assign(n + 1, 0);
+        pred_offsets_.assign(n + 1, 0);
+        succs_.clear();
+        preds_.clear();
+        for (std::size_t id = 0; id < n; ++id) {
+            const auto& node = graph.nodes()[id];
+            succs_.insert(succs_.end(), node.successors.begin(), node.successors.end());
+            preds_.insert(preds_.end(), node.predecessors.begin(), node.predecessors.end());
+            succ_offsets_[id + 1] = static_cast<std::uint32_t>(succs_.size());
+            pred_offsets_[id + 1] = static_cast<std::uint32_t>(preds_.size());
+        }
+    }
+
+    std::size_t size() const { return succ_offsets_.empty() ? 0 : succ_offsets_.size() - 1; }
+
+    Range successors(NodeId id) const {
+        return {succs_.data() + succ_offsets_[id], succs_.data() + succ_offsets_[id + 1]};
+    }
+
+    Range predecessors(NodeId id) const {
+        return {preds_.data() + pred_offsets_[id], preds_.data() + pred_offsets_[id + 1]};
+    }
+
+    std::uint32_t out_degree(NodeId id) const { return succ_offsets_[id + 1] - succ_offsets_[id]; }
+    std::uint32_t in_degree(NodeId id) const { return pred_offsets_[id + 1] - pred_offsets_[id]; }
+
+private:
+    std::vector<std::uint32_t> succ_offsets_;
+    std::vector<NodeId> succs_;
+    std::vector<std::uint32_t> pred_offsets_;
+    std::vector<NodeId> preds_;
+};
+
+} // namespace dag
@@ -0,0 +1,573 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DAG_GRAPH_FILE_MMAP 1
+#endif
+
+#include "graph_validation.hpp"
+#include "task_graph.hpp"
+
+/*
+ * GRAPH FILES - DAG TOPOLOGIES LOADED AT STARTUP
+ *
+ * A graph's shape can live in a file instead of in code, so it can be changed
+ * without rebuilding the program. Graphs are written as text:
+ *
+ *     # 3 sources -> 2 transforms -> 1 aggregate
+ *     node fetch_a   sleep  cost=10 param=10
+ *     node fetch_b   sleep  cost=8  param=8
+ *     node combine   glue   cost=0.01 after fetch_a fetch_b
+ *
+ *     node <name> <kind> [cost=<number>] [param=<number>] [after <name>...]
+ *
+ * and compiled (see the dag_compile tool) into a binary file that is mapped
+ * into memory as is:
+ *
+ *     GraphFileHeader                         32 bytes, magic + counts
+ *     u32    pred_offsets[nodes + 1]          CSR: predecessors of node i are
+ *     u32    preds[edges]                       preds[pred_offsets[i] .. [i+1])
+ *     u32    kinds[nodes]                     index into kind_names
+ *     u32    names[nodes]                     offset into strings
+ *     double costs[nodes], params[nodes]
+ *     u32    kind_names[kind_count]           offset into strings
+ *     char   strings[string_bytes]            NUL-terminated names
+ *
+ * every array starting on an 8-byte boundary. The compiler orders nodes
+ * topologically (nodes may be written in any order; a cycle is an error), so
+ * a node's predecessors always have smaller ids, as in TaskGraph.
+ *
+ * Opening a GraphFile maps it and checks it in one O(V+E) pass - bounds,
+ * ordering, string table - without copying anything; its accessors read the
+ * mapping directly. load_task_graph() turns it into a TaskGraph, asking a
+ * NodeKinds table for the function of every node by the node's kind. A kind
+ * is what a node does ("sleep", "glue", "fetch"); `param` is its one numeric
+ * argument and `cost` its estimate for critical-path priority.
+ *
+ * Files use the byte order of the machine that compiled them; a marker in
+ * the header rejects files of the other byte order.
+ */
+
+namespace dag {
+
+class GraphFileError : public std::runtime_error {
+public:
+    GraphFileError(const std::string& source, const std::string& message)
+        : std::runtime_error(source + ": " + message) {}
+};
+
+// A graph as written in the text form, before compilation
+struct GraphSpec {
+    struct Node {
+        std::string name;
+        std::string kind;
+        double cost = 1.0;
+        double param = 0.0;
+        std::vector<std::string> after;  // predecessor names
+    };
+
+    std::vector<Node> nodes;
+};
+
+struct GraphFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t node_count;
+    std::uint32_t edge_count;
+    std::uint32_t kind_count;
+    std::uint32_t string_bytes;
+    std::uint32_t endian_check;  // kEndianCheck as written
+};
+
+static_assert(sizeof(GraphFileHeader) == 32, "GraphFileHeader is part of the file format");
+static_assert(std::is_same_v<NodeId, std::uint32_t>, "graph files store node ids as u32");
+
+namespace graph_file_detail {
+
+constexpr char kMagic[8] = {'D', 'A', 'G', 'G', 'R', 'A', 'P', 'H'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kEndianCheck = 0x01020304;
+
+constexpr std::size_t align8(std::size_t bytes) { return (bytes + 7) & ~std::size_t(7); }
+
+// Byte offsets of the arrays that follow the header
+struct Layout {
+    std::size_t pred_offsets, preds, kinds, names, costs, params, kind_names, strings, total;
+
+    Layout(std::size_t nodes, std::size_t edges, std::size_t kinds_count, std::size_t string_bytes) {
+        std::size_t at = sizeof(GraphFileHeader);
+        auto take = [&at](std::size_t bytes) {
+            const std::size_t start = at;
+            at = align8(at + bytes);
+            return start;
+        };
+        pred_offsets = take((nodes + 1) * sizeof(std::uint32_t));
+        preds = take(edges * sizeof(std::uint32_t));
+        kinds = take(nodes * sizeof(std::uint32_t));
+        names = take(nodes * sizeof(std::uint32_t));
+        costs = take(nodes * sizeof(double));
+        params = take(nodes * sizeof(double));
+        kind_names = take(kinds_count * sizeof(std::uint32_t));
+        strings = take(string_bytes);
+        total = at;
+    }
+};
+
+} // namespace graph_file_detail
+
+// Parses the text form; errors name the source and line
+inline GraphSpec parse_graph_text(std::istream& in, const std::string& source = "<graph>") {
+    GraphSpec spec;
+    std::string line;
+    for (std::size_t number = 1; std::getline(in, line); ++number) {
+        const std::size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::istringstream words(line);
+        std::string keyword;
+        if (!(words >> keyword)) {
+            continue;
+        }
+        const std::string where = source + ":" + std::to_string(number);
+        if (keyword != "node") {
+            throw GraphFileError(where, "expected 'node', got '" + keyword + "'");
+        }
+
+        GraphSpec::Node node;
+        if (!(words >> node.name >> node.kind)) {
+            throw GraphFileError(where, "expected 'node <name> <kind>'");
+        }
+        std::string word;
+        bool after = false;
+        while (words >> word) {
+            if (after) {
+                node.after.push_back(word);
+            } else if (word == "after") {
+                after = true;
+            } else if (word.rfind("cost=", 0) == 0 || word.rfind("param=", 0) == 0) {
+                const std::size_t eq = word.find('=');
+                try {
+                    std::size_t used = 0;
+                    const double value = std::stod(word.substr(eq + 1), &used);
+                    if (used != word.size() - eq - 1) {
+                        throw std::invalid_argument(word);
+                    }
+                    (word[0] == 'c' ? node.cost : node.param) = value;
+                } catch (const std::exception&) {
+                    throw GraphFileError(where, "bad number in '" + word + "'");
+                }
+            } else {
+                throw GraphFileError(where, "unexpected '" + word + "'");
+            }
+        }
+        spec.nodes.push_back(std::move(node));
+    }
+    return spec;
+}
+
+inline GraphSpec parse_graph_text_file(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw GraphFileError(path, "cannot open");
+    }
+    return parse_graph_text(in, path);
+}
+
+namespace graph_file_detail {
+
+// A GraphSpec with names resolved to declaration indices, for validate_shape();
+// unknown names become out-of-range ids, reported as bad edges
+struct SpecShape {
+    const GraphSpec& spec;
+    std::vector<std::uint32_t> offsets;
+    std::vector<NodeId> preds;
+
+    explicit SpecShape(const GraphSpec& s) : spec(s), offsets(s.nodes.size() + 1, 0) {
+        std::unordered_map<std::string, NodeId> index;
+        index.reserve(s.nodes.size());
+        for (std::size_t i = 0; i < s.nodes.size(); ++i) {
+            index.emplace(s.nodes[i].name, static_cast<NodeId>(i));
+        }
+        for (std::size_t i = 0; i < s.nodes.size(); ++i) {
+            for (const std::string& pred : s.nodes[i].after) {
+                auto found = index.find(pred);
+                preds.push_back(found != index.end() ? found->second : std::numeric_limits<NodeId>::max());
+            }
+            offsets[i + 1] = static_cast<std::uint32_t>(preds.size());
+        }
+    }
+
+    std::size_t size() const { return spec.nodes.size(); }
+    std::pair<const NodeId*, const NodeId*> predecessors(NodeId id) const {
+        return {preds.data() + offsets[id], preds.data() + offsets[id + 1]};
+    }
+    double cost(NodeId id) const { return spec.nodes[id].cost; }
+};
+
+} // namespace graph_file_detail
+
+// Validates a graph as parsed, before compilation; node ids in the report
+// are declaration indices
+inline GraphReport validate_graph(const GraphSpec& spec, const ValidationOptions& options = {}) {
+    return validate_shape(graph_file_detail::SpecShape(spec), options);
+}
+
+// Orders the nodes topologically (declaration order among ready nodes) and
+// lays them out in the binary format
+inline std::vector<char> compile_graph(const GraphSpec& spec, const std::string& source = "<graph>") {
+    using namespace graph_file_detail;
+    const std::size_t n = spec.nodes.size();
+
+    std::unordered_map<std::string, std::uint32_t> index;
+    index.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!index.emplace(spec.nodes[i].name, static_cast<std::uint32_t>(i)).second) {
+            throw GraphFileError(source, "node " + spec.nodes[i].name + " is defined twice");
+        }
+    }
+
+    // Kahn's algorithm over declaration indices
+    std::vector<std::vector<std::uint32_t>> successors(n);
+    std::vector<std::uint32_t> in_degree(n, 0);
+    std::size_t edges = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (const std::string& pred : spec.nodes[i].after) {
+            auto found = index.find(pred);
+            if (found == index.end()) {
+                throw GraphFileError(source, "node " + spec.nodes[i].name + " depends on unknown node " + pred);
+            }
+            successors[found->second].push_back(static_cast<std::uint32_t>(i));
+            ++in_degree[i];
+            ++edges;
+        }
+    }
+    std::vector<std::uint32_t> order;
+    order.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (in_degree[i] == 0) {
+            order.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    for (std::size_t head = 0; head < order.size(); ++head) {
+        for (std::uint32_t succ : successors[order[head]]) {
+            if (--in_degree[succ] == 0) {
+                order.push_back(succ);
+            }
+        }
+    }
+    if (order.size() != n) {
+        ValidationOptions options;
+        options.memory_budget = 0;
+        const std::vector<NodeId> cycle = validate_graph(spec, options).cycle;
+        std::string names;
+        for (NodeId id : cycle) {
+            names += spec.nodes[id].name + " -> ";
+        }
+        throw GraphFileError(source, "the graph has a cycle: " + names + spec.nodes[cycle.front()].name);
+    }
+    std::vector<std::uint32_t> id_of(n);
+    for (std::size_t id = 0; id < n; ++id) {
+        id_of[order[id]] = static_cast<std::uint32_t>(id);
+    }
+
+    // String table: node names, then kind names
+    std::string strings;
+    std::vector<std::uint32_t> names(n);
+    for (std::size_t id = 0; id < n; ++id) {
+        names[id] = static_cast<std::uint32_t>(strings.size());
+        strings += spec.nodes[order[id]].name;
+        strings += '\0';
+    }
+    std::unordered_map<std::string, std::uint32_t> kind_index;
+    std::vector<std::uint32_t> kind_names;
+    std::vector<std::uint32_t> kinds(n);
+    for (std::size_t id = 0; id < n; ++id) {
+        const std::string& kind = spec.nodes[order[id]].kind;
+        auto inserted = kind_index.emplace(kind, static_cast<std::uint32_t>(kind_names.size()));
+        if (inserted.second) {
+            kind_names.push_back(static_cast<std::uint32_t>(strings.size()));
+            strings += kind;
+            strings += '\0';
+        }
+        kinds[id] = inserted.first->second;
+    }
+
+    const Layout layout(n, edges, kind_names.size(), strings.size());
+    std::vector<char> bytes(layout.total, 0);
+    auto put = [&bytes](std::size_t at, const void* data, std::size_t size) {
+        if (size != 0) {
+            std::memcpy(bytes.data() + at, data, size);
+        }
+    };
+
+    GraphFileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.node_count = static_cast<std::uint32_t>(n);
+    header.edge_count = static_cast<std::uint32_t>(edges);
+    header.kind_count = static_cast<std::uint32_t>(kind_names.size());
+    header.string_bytes = static_cast<std::uint32_t>(strings.size());
+    header.endian_check = kEndianCheck;
+    put(0, &header, sizeof(header));
+
+    std::vector<std::uint32_t> pred_offsets(n + 1, 0);
+    std::vector<std::uint32_t> preds;
+    std::vector<double> costs(n), params(n);
+    preds.reserve(edges);
+    for (std::size_t id = 0; id < n; ++id) {
+        const GraphSpec::Node& node = spec.nodes[order[id]];
+        for (const std::string& pred : node.after) {
+            preds.push_back(id_of[index.at(pred)]);
+        }
+        pred_offsets[id + 1] = static_cast<std::uint32_t>(preds.size());
+        costs[id] = node.cost;
+        params[id] = node.param;
+    }
+    put(layout.pred_offsets, pred_offsets.data(), pred_offsets.size() * sizeof(std::uint32_t));
+    put(layout.preds, preds.data(), preds.size() * sizeof(std::uint32_t));
+    put(layout.kinds, kinds.data(), kinds.size() * sizeof(std::uint32_t));
+    put(layout.names, names.data(), names.size() * sizeof(std::uint32_t));
+    put(layout.costs, costs.data(), costs.size() * sizeof(double));
+    put(layout.params, params.data(), params.size() * sizeof(double));
+    put(layout.kind_names, kind_names.data(), kind_names.size() * sizeof(std::uint32_t));
+    put(layout.strings, strings.data(), strings.size());
+    return bytes;
+}
+
+// `source` names the graph in compile errors; the output path by default
+inline void write_graph_file(const GraphSpec& spec, const std::string& path, const std::string& source = {}) {
+    const std::vector<char> bytes = compile_graph(spec, source.empty() ? path : source);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+        throw GraphFileError(path, "cannot write");
+    }
+}
+
+// A compiled graph file, mapped read-only; valid once constructed
+class GraphFile {
+public:
+    struct NodeView {
+        NodeId id;
+        std::string_view name;
+        std::string_view kind;
+        double cost;
+        double param;
+    };
+
+private:
+    std::string path_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<char> buffer_;  // where mmap is not available
+
+    const GraphFileHeader* header_ = nullptr;
+    const std::uint32_t* pred_offsets_ = nullptr;
+    const std::uint32_t* preds_ = nullptr;
+    const std::uint32_t* kinds_ = nullptr;
+    const std::uint32_t* names_ = nullptr;
+    const double* costs_ = nullptr;
+    const double* params_ = nullptr;
+    const std::uint32_t* kind_names_ = nullptr;
+    const char* strings_ = nullptr;
+
+    template<typename T>
+    const T* at(std::size_t offset) const {
+        return reinterpret_cast<const T*>(data_ + offset);
+    }
+
+    void map() {
+#if defined(DAG_GRAPH_FILE_MMAP)
+        const int fd = ::open(path_.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw GraphFileError(path_, "cannot open");
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw GraphFileError(path_, "cannot stat");
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+        if (size_ != 0) {
+            void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                throw GraphFileError(path_, "cannot map");
+            }
+            data_ = static_cast<const char*>(mapping);
+            mapped_ = true;
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path_, std::ios::binary);
+        if (!in) {
+            throw GraphFileError(path_, "cannot open");
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    void unmap() {
+#if defined(DAG_GRAPH_FILE_MMAP)
+        if (mapped_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+        mapped_ = false;
+        data_ = nullptr;
+    }
+
+    void fail(const std::string& message) const { throw GraphFileError(path_, message); }
+
+    // Every offset and index is checked once here, so accessors need not
+    void validate() {
+        using namespace graph_file_detail;
+        if (size_ < sizeof(GraphFileHeader)) {
+            fail("too small for a graph file");
+        }
+        header_ = at<GraphFileHeader>(0);
+        if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0) {
+            fail("not a compiled graph file");
+        }
+        if (header_->endian_check != kEndianCheck) {
+            fail("compiled on a machine with the other byte order");
+        }
+        if (header_->version != kVersion) {
+            fail("format version " + std::to_string(header_->version) + ", expected " + std::to_string(kVersion));
+        }
+        const std::size_t n = header_->node_count;
+        const Layout layout(n, header_->edge_count, header_->kind_count, header_->string_bytes);
+        if (size_ < layout.total) {
+            fail("truncated");
+        }
+        pred_offsets_ = at<std::uint32_t>(layout.pred_offsets);
+        preds_ = at<std::uint32_t>(layout.preds);
+        kinds_ = at<std::uint32_t>(layout.kinds);
+        names_ = at<std::uint32_t>(layout.names);
+        costs_ = at<double>(layout.costs);
+        params_ = at<double>(layout.params);
+        kind_names_ = at<std::uint32_t>(layout.kind_names);
+        strings_ = at<char>(layout.strings);
+
+        // A terminated table makes every in-range offset a terminated string
+        const std::uint32_t string_bytes = header_->string_bytes;
+        if (string_bytes != 0 && strings_[string_bytes - 1] != '\0') {
+            fail("string table is not terminated");
+        }
+        if (pred_offsets_[0] != 0 || pred_offsets_[n] != header_->edge_count) {
+            fail("predecessor offsets do not cover the edge array");
+        }
+        for (std::size_t id = 0; id < n; ++id) {
+            if (pred_offsets_[id] > pred_offsets_[id + 1]) {
+                fail("predecessor offsets of node " + std::to_string(id) + " decrease");
+            }
+            for (std::uint32_t e = pred_offsets_[id]; e < pred_offsets_[id + 1]; ++e) {
+                if (preds_[e] >= id) {
+                    fail("node " + std::to_string(id) + " depends on a later node; the file is not topologically ordered");
+                }
+            }
+            if (kinds_[id] >= header_->kind_count || names_[id] >= string_bytes) {
+                fail("node " + std::to_string(id) + " has an out-of-range kind or name");
+            }
+        }
+        for (std::size_t k = 0; k < header_->kind_count; ++k) {
+            if (kind_names_[k] >= string_bytes) {
+                fail("kind " + std::to_string(k) + " has an out-of-range name");
+            }
+        }
+    }
+
+public:
+    explicit GraphFile(std::string path) : path_(std::move(path)) {
+        map();
+        try {
+            validate();
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    ~GraphFile() { unmap(); }
+
+    GraphFile(const GraphFile&) = delete;
+    GraphFile& operator=(const GraphFile&) = delete;
+
+    const std::string& path() const { return path_; }
+    std::size_t size() const { return header_->node_count; }
+    std::size_t edge_count() const { return header_->edge_count; }
+    std::size_t kind_count() const { return header_->kind_count; }
+    std::size_t file_bytes() const { return size_; }
+
+    // Predecessor ids of a node, as [first, last)
+    std::pair<const NodeId*, const NodeId*> predecessors(NodeId id) const {
+        return {preds_ + pred_offsets_[id], preds_ + pred_offsets_[id + 1]};
+    }
+
+    std::string_view name(NodeId id) const { return strings_ + names_[id]; }
+    std::uint32_t kind_id(NodeId id) const { return kinds_[id]; }
+    std::string_view kind_name(std::uint32_t kind) const { return strings_ + kind_names_[kind]; }
+    double cost(NodeId id) const { return costs_[id]; }
+    double param(NodeId id) const { return params_[id]; }
+
+    NodeView node(NodeId id) const {
+        return NodeView{id, name(id), kind_name(kinds_[id]), costs_[id], params_[id]};
+    }
+};
+
+// Builds a node's function from its description in the file. The views
+// point into the mapping: copy what the function keeps.
+template<typename Value>
+using NodeKinds = std::unordered_map<std::string, std::function<typename TaskGraph<Value>::TaskFn(const GraphFile::NodeView&)>>;
+
+// Creates the TaskGraph a graph file describes; every kind used in the file
+// must be in `kinds`. Value is not deduced: load_task_graph<int>(file, kinds).
+template<typename Value>
+TaskGraph<Value> load_task_graph(const GraphFile& file, const NodeKinds<Value>& kinds) {
+    std::vector<const typename NodeKinds<Value>::mapped_type*> factories(file.kind_count());
+    for (std::uint32_t kind = 0; kind < file.kind_count(); ++kind) {
+        auto found = kinds.find(std::string(file.kind_name(kind)));
+        if (found == kinds.end()) {
+            throw GraphFileError(file.path(), "no node kind named " + std::string(file.kind_name(kind)));
+        }
+        factories[kind] = &found->second;
+    }
+
+    TaskGraph<Value> graph;
+    graph.reserve(file.size());
+    for (NodeId id = 0; id < file.size(); ++id) {
+        const GraphFile::NodeView view = file.node(id);
+        const auto preds = file.predecessors(id);
+        graph.add_node(std::string(view.name), std::vector<NodeId>(preds.first, preds.second),
+                       (*factories[file.kind_id(id)])(view), view.cost);
+    }
+    return graph;
+}
+
+} // namespace dag
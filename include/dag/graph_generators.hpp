@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "task_graph.hpp"
+
+/*
+ * GRAPH GENERATORS - SYNTHETIC TASK GRAPHS OF A GIVEN SHAPE
+ *
+ * Benchmarks need graphs far larger than anything written by hand, in shapes
+ * that stress different parts of a scheduler:
+ *
+ *     wide            one source, `width` independent nodes, one sink
+ *                     - parallelism limited only by the pool
+ *     deep            a chain of `depth` nodes
+ *                     - no parallelism; every edge is on the critical path
+ *     random          node i depends on up to `max_fan_in` random nodes among
+ *                     the `window` before it - irregular, like real pipelines
+ *     diamond lattice a rows x cols grid, (r, c) after (r-1, c) and (r, c-1)
+ *                     - a wavefront: parallelism grows, then shrinks
+ *     fork-join       `stages` forks of `width` nodes, each joined before
+ *                     the next fork - a barrier per stage
+ *
+ * Every node gets the same work function and cost, so a graph's run time is
+ * its shape plus the scheduler's overhead. Nodes are added in topological
+ * order, like any TaskGraph, and random graphs are reproducible from their
+ * seed.
+ */
+
+namespace dag {
+
+template<typename Value>
+TaskGraph<Value> make_wide_graph(std::size_t width, const typename TaskGraph<Value>::TaskFn& work, double cost = 1.0) {
+    TaskGraph<Value> graph;
+    graph.reserve(width + 2);
+    const NodeId source = graph.add_node("source", {}, work, cost);
+    std::vector<NodeId> leaves;
+    leaves.reserve(width);
+    for (std::size_t i = 0; i < width; ++i) {
+        leaves.push_back(graph.add_node("leaf" + std::to_string(i), {source}, work, cost));
+    }
+    graph.add_node("sink", std::move(leaves), work, cost);
+    return graph;
+}
+
+template<typename Value>
+TaskGraph<Value> make_deep_graph(std::size_t depth, const typename TaskGraph<Value>::TaskFn& work, double cost = 1.0) {
+    TaskGraph<Value> graph;
+    graph.reserve(depth);
+    for (std::size_t i = 0; i < depth; ++i) {
+        std::vector<NodeId> preds;
+        if (i > 0) {
+            preds.push_back(static_cast<NodeId>(i - 1));
+        }
+        graph.add_node("link" + std::to_string(i), std::move(preds), work, cost);
+    }
+    return graph;
+}
+
+// Node 0 is a source; every later node depends on 1..max_fan_in distinct
+// nodes among the `window` added just before it
+template<typename Value>
+TaskGraph<Value> make_random_graph(std::size_t nodes, std::size_t max_fan_in, std::size_t window, unsigned seed,
+                                   const typename TaskGraph<Value>::TaskFn& work, double cost = 1.0) {
+    std::mt19937 rng(seed);
+    TaskGraph<Value> graph;
+    graph.reserve(nodes);
+    for (std::size_t i = 0; i < nodes; ++i) {
+        std::vector<NodeId> preds;
+        if (i > 0) {
+            const std::size_t first = i > window ? i - window : 0;
+            std::uniform_int_distribution<std::size_t> pick(first, i - 1);
+            std::uniform_int_distribution<std::size_t> fan_in(1, std::max<std::size_t>(max_fan_in, 1));
+            for (std::size_t k = fan_in(rng); k > 0; --k) {
+                preds.push_back(static_cast<NodeId>(pick(rng)));
+            }
+            std::sort(preds.begin(), preds.end());
+            preds.erase(std::unique(preds.begin(), preds.end()), preds.end());
+        }
+        graph.add_node("n" + std::to_string(i), std::move(preds), work, cost);
+    }
+    return graph;
+}
+
+template<typename Value>
+TaskGraph<Value> make_diamond_lattice(std::size_t rows, std::size_t cols, const typename TaskGraph<Value>::TaskFn& work,
+                                      double cost = 1.0) {
+    TaskGraph<Value> graph;
+    graph.reserve(rows * cols);
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t c = 0; c < cols; ++c) {
+            std::vector<NodeId> preds;
+            if (r > 0) {
+                preds.push_back(static_cast<NodeId>((r - 1) * cols + c));
+            }
+            if (c > 0) {
+                preds.push_back(static_cast<NodeId>(r * cols + c - 1));
+            }
+            graph.add_node("d" + std::to_string(r) + "_" + std::to_string(c), std::move(preds), work, cost);
+        }
+    }
+    return graph;
+}
+
+// fork0 -> `width` nodes -> fork1 -> ... -> fork<stages>
+template<typename Value>
+TaskGraph<Value> make_fork_join_graph(std::size_t stages, std::size_t width,
+                                      const typename TaskGraph<Value>::TaskFn& work, double cost = 1.0) {
+    TaskGraph<Value> graph;
+    graph.reserve(stages * (width + 1) + 1);
+    NodeId fork = graph.add_node("fork0", {}, work, cost);
+    for (std::size_t stage = 0; stage < stages; ++stage) {
+        std::vector<NodeId> branches;
+        branches.reserve(width);
+        for (std::size_t i = 0; i < width; ++i) {
+            branches.push_back(graph.add_node("branch" + std::to_string(stage) + "_" + std::to_string(i), {fork},
+                                              work, cost));
+        }
+        fork = graph.add_node("fork" + std::to_string(stage + 1), std::move(branches), work, cost);
+    }
+    return graph;
+}
+
+} // namespace dag
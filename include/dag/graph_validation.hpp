@@ -0,0 +1,364 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flat_graph.hpp"
+#include "task_graph.hpp"
+
+/*
+ * GRAPH VALIDATION - CHECKING A GRAPH BEFORE IT RUNS
+ *
+ * validate_graph() checks a graph in O(V+E) time and reports:
+ *
+ * - edges to nodes that do not exist,
+ * - one cycle, node by node, if the graph has any,
+ * - unreachable nodes: nodes that can never become ready from the roots
+ *   (every source by default). A node becomes ready once all of its
+ *   predecessors have, so one unreachable predecessor - a source not listed
+ *   as a root, a node on or behind a cycle - is enough,
+ * - shape statistics: sources, sinks, levels (longest path in nodes), the
+ *   widest level, total cost, and the critical path - the most expensive
+ *   chain of nodes - with its cost.
+ *
+ * Scratch memory is bounded: a graph whose predecessors all have smaller ids
+ * (every TaskGraph, every compiled GraphFile) is checked in one forward pass
+ * with 17 bytes per node and nothing per edge. Only a graph in arbitrary
+ * order (a GraphSpec as parsed, a generated edge list) needs its successor
+ * lists built, 4 more bytes per edge and 12 per node, and is then checked
+ * with Kahn's algorithm. The bytes needed are computed before anything is
+ * allocated; past ValidationOptions::memory_budget validate_graph() throws
+ * GraphValidationError instead of allocating.
+ *
+ * A graph is any type with
+ *
+ *     std::size_t size() const;
+ *     std::pair<const NodeId*, const NodeId*> predecessors(NodeId) const;
+ *     double cost(NodeId) const;
+ *
+ * GraphFile is one as it is; validate_graph() adapts a TaskGraph, and a
+ * GraphSpec (see graph_file.hpp, whose compiler uses it to name the cycle
+ * it rejects). GraphExecutor runs the same check as a pre-pass, once per
+ * graph, when ExecutorOptions::validate is set.
+ */
+
+namespace dag {
+
+class GraphValidationError : public std::runtime_error {
+public:
+    explicit GraphValidationError(const std::string& message) : std::runtime_error(message) {}
+};
+
+struct ValidationOptions {
+    std::vector<NodeId> roots;               // empty = every source
+    std::size_t memory_budget = std::size_t(1) << 30;  // scratch bytes, 0 = unlimited
+    std::size_t max_listed = 16;             // unreachable nodes / bad edges kept
+};
+
+struct GraphReport {
+    std::size_t nodes = 0;
+    std::size_t edges = 0;
+    std::size_t sources = 0;
+    std::size_t sinks = 0;
+
+    std::vector<std::pair<NodeId, NodeId>> bad_edges;  // (node, missing predecessor)
+    std::size_t bad_edge_count = 0;
+
+    std::vector<NodeId> cycle;          // each node depends on the one before it
+    std::vector<NodeId> unreachable;    // the first max_listed
+    std::size_t unreachable_count = 0;
+
+    std::size_t levels = 0;             // nodes on the longest path
+    std::size_t widest_level = 0;       // index of the level with most nodes
+    std::size_t widest_level_size = 0;
+    double total_cost = 0.0;
+    double critical_path_cost = 0.0;
+    std::vector<NodeId> critical_path;  // source to sink
+    bool ordered = true;                // every predecessor has a smaller id
+    std::size_t scratch_bytes = 0;
+
+    bool valid() const { return bad_edge_count == 0 && cycle.empty() && unreachable_count == 0; }
+};
+
+namespace validation_detail {
+
+// Bytes of scratch validate_shape() will allocate
+inline std::size_t scratch_bytes(std::size_t nodes, std::size_t edges, bool ordered) {
+    // level + parent (u32), finish (double), flags (u8)
+    std::size_t bytes = nodes * (4 + 4 + 8 + 1);
+    if (!ordered) {
+        // successor offsets and lists, remaining in-degree, ready queue
+        bytes += (nodes + 1) * 4 + edges * 4 + nodes * 4 + nodes * 4;
+    }
+    return bytes;
+}
+
+constexpr std::uint8_t kReachable = 1;
+constexpr std::uint8_t kHasSuccessor = 2;
+constexpr std::uint8_t kDone = 4;
+
+} // namespace validation_detail
+
+template<typename Shape>
+GraphReport validate_shape(const Shape& shape, const ValidationOptions& options = {}) {
+    using namespace validation_detail;
+    constexpr NodeId kNone = std::numeric_limits<NodeId>::max();
+
+    GraphReport report;
+    const std::size_t n = shape.size();
+    report.nodes = n;
+
+    // Pass 1: count edges, find dangling ones, check the order
+    for (NodeId id = 0; id < n; ++id) {
+        auto preds = shape.predecessors(id);
+        report.edges += static_cast<std::size_t>(preds.second - preds.first);
+        report.sources += preds.first == preds.second ? 1 : 0;
+        for (; preds.first != preds.second; ++preds.first) {
+            if (*preds.first >= n) {
+                if (report.bad_edges.size() < options.max_listed) {
+                    report.bad_edges.emplace_back(id, *preds.first);
+                }
+                ++report.bad_edge_count;
+            } else if (*preds.first >= id) {
+                report.ordered = false;
+            }
+        }
+        report.total_cost += shape.cost(id);
+    }
+    if (report.bad_edge_count != 0) {
+        return report;
+    }
+
+    report.scratch_bytes = scratch_bytes(n, report.edges, report.ordered);
+    if (options.memory_budget != 0 && report.scratch_bytes > options.memory_budget) {
+        throw GraphValidationError("validating " + std::to_string(n) + " nodes and " +
+                                   std::to_string(report.edges) + " edges needs " +
+                                   std::to_string(report.scratch_bytes) + " bytes, over the budget of " +
+                                   std::to_string(options.memory_budget));
+    }
+
+    std::vector<std::uint32_t> level(n, 0);
+    std::vector<NodeId> parent(n, kNone);   // predecessor on the most expensive path
+    std::vector<double> finish(n, 0.0);     // cost of that path, including the node
+    std::vector<std::uint8_t> flags(n, 0);
+    for (NodeId root : options.roots) {
+        if (root < n) {
+            flags[root] |= kReachable;
+        }
+    }
+    const bool all_sources = options.roots.empty();
+
+    // Settles a node whose predecessors are all settled
+    auto settle = [&](NodeId id) {
+        auto preds = shape.predecessors(id);
+        const bool source = preds.first == preds.second;
+        if (source && all_sources) {
+            flags[id] |= kReachable;
+        }
+        double longest = 0.0;
+        bool preds_reachable = !source;
+        for (; preds.first != preds.second; ++preds.first) {
+            const NodeId pred = *preds.first;
+            flags[pred] |= kHasSuccessor;
+            level[id] = std::max(level[id], level[pred] + 1);
+            if (parent[id] == kNone || finish[pred] > longest) {
+                longest = finish[pred];
+                parent[id] = pred;
+            }
+            preds_reachable = preds_reachable && (flags[pred] & kReachable);
+        }
+        if (preds_reachable) {
+            flags[id] |= kReachable;
+        }
+        finish[id] = longest + shape.cost(id);
+        flags[id] |= kDone;
+    };
+
+    if (report.ordered) {
+        for (NodeId id = 0; id < n; ++id) {
+            settle(id);
+        }
+    } else {
+        // Kahn's algorithm over successor lists built from the predecessors
+        std::vector<std::uint32_t> succ_offsets(n + 1, 0);
+        std::vector<std::uint32_t> remaining(n, 0);
+        for (NodeId id = 0; id < n; ++id) {
+            auto preds = shape.predecessors(id);
+            remaining[id] = static_cast<std::uint32_t>(preds.second - preds.first);
+            for (; preds.first != preds.second; ++preds.first) {
+                ++succ_offsets[*preds.first + 1];
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            flags[i] |= succ_offsets[i + 1] != 0 ? kHasSuccessor : 0;
+            succ_offsets[i + 1] += succ_offsets[i];
+        }
+        std::vector<NodeId> succs(report.edges);
+        {
+            std::vector<std::uint32_t>& fill = level;  // unused until nodes settle
+            for (NodeId id = 0; id < n; ++id) {
+                for (auto preds = shape.predecessors(id); preds.first != preds.second; ++preds.first) {
+                    succs[succ_offsets[*preds.first] + fill[*preds.first]++] = id;
+                }
+            }
+            std::fill(fill.begin(), fill.end(), 0);
+        }
+
+        std::vector<NodeId> queue;
+        queue.reserve(n);
+        for (NodeId id = 0; id < n; ++id) {
+            if (remaining[id] == 0) {
+                queue.push_back(id);
+            }
+        }
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const NodeId id = queue[head];
+            settle(id);
+            for (std::uint32_t e = succ_offsets[id]; e < succ_offsets[id + 1]; ++e) {
+                if (--remaining[succs[e]] == 0) {
+                    queue.push_back(succs[e]);
+                }
+            }
+        }
+
+        // Every unsettled node has an unsettled predecessor: following them
+        // from any unsettled node must come back to a node already visited
+        if (queue.size() != n) {
+            NodeId at = 0;
+            while (flags[at] & kDone) {
+                ++at;
+            }
+            std::vector<NodeId> walk;
+            std::vector<std::uint32_t>& seen_at = level;  // position in walk + 1
+            while (seen_at[at] == 0) {
+                walk.push_back(at);
+                seen_at[at] = static_cast<std::uint32_t>(walk.size());
+                auto preds = shape.predecessors(at);
+                at = *std::find_if(preds.first, preds.second, [&flags](NodeId pred) { return !(flags[pred] & kDone); });
+            }
+            report.cycle.assign(walk.begin() + (seen_at[at] - 1), walk.end());
+            std::reverse(report.cycle.begin(), report.cycle.end());
+            for (NodeId id : walk) {
+                seen_at[id] = 0;
+            }
+        }
+    }
+
+    // Shape statistics over the settled nodes
+    std::vector<std::uint32_t> width;
+    NodeId last = kNone;
+    for (NodeId id = 0; id < n; ++id) {
+        report.sinks += flags[id] & kHasSuccessor ? 0 : 1;
+        if (!(flags[id] & kReachable)) {
+            if (report.unreachable.size() < options.max_listed) {
+                report.unreachable.push_back(id);
+            }
+            ++report.unreachable_count;
+        }
+        if (!(flags[id] & kDone)) {
+            continue;
+        }
+        if (level[id] >= width.size()) {
+            width.resize(level[id] + 1, 0);
+        }
+        ++width[level[id]];
+        if (last == kNone || finish[id] > finish[last]) {
+            last = id;
+        }
+    }
+    report.levels = width.size();
+    for (std::size_t l = 0; l < width.size(); ++l) {
+        if (width[l] > report.widest_level_size) {
+            report.widest_level_size = width[l];
+            report.widest_level = l;
+        }
+    }
+    if (last != kNone) {
+        report.critical_path_cost = finish[last];
+        for (NodeId id = last; id != kNone; id = parent[id]) {
+            report.critical_path.push_back(id);
+        }
+        std::reverse(report.critical_path.begin(), report.critical_path.end());
+    }
+    return report;
+}
+
+namespace validation_detail {
+
+template<typename Value>
+struct TaskGraphShape {
+    const TaskGraph<Value>& graph;
+
+    std::size_t size() const { return graph.size(); }
+    std::pair<const NodeId*, const NodeId*> predecessors(NodeId id) const {
+        const auto& preds = graph.nodes()[id].predecessors;
+        return {preds.data(), preds.data() + preds.size()};
+    }
+    double cost(NodeId id) const { return graph.nodes()[id].cost; }
+};
+
+template<typename Value>
+struct FlatGraphShape {
+    const FlatGraph& flat;
+    const TaskGraph<Value>& graph;
+
+    std::size_t size() const { return flat.size(); }
+    std::pair<const NodeId*, const NodeId*> predecessors(NodeId id) const { return flat.predecessors(id); }
+    double cost(NodeId id) const { return graph.nodes()[id].cost; }
+};
+
+} // namespace validation_detail
+
+template<typename Value>
+GraphReport validate_graph(const TaskGraph<Value>& graph, const ValidationOptions& options = {}) {
+    return validate_shape(validation_detail::TaskGraphShape<Value>{graph}, options);
+}
+
+// Human-readable report; `name` turns an id into a node name
+inline void print_report(std::ostream& out, const GraphReport& report, const std::function<std::string(NodeId)>& name) {
+    auto list = [&out, &name](const std::vector<NodeId>& ids, const char* separator) {
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            out << (i == 0 ? "" : separator) << name(ids[i]);
+        }
+    };
+
+    out << "  " << report.nodes << " nodes, " << report.edges << " edges, " << report.sources << " sources, "
+        << report.sinks << " sinks" << (report.ordered ? "" : " (not in topological order)") << "\n";
+    for (const auto& [node, pred] : report.bad_edges) {
+        out << "  ❌ " << name(node) << " depends on missing node #" << pred << "\n";
+    }
+    if (report.bad_edge_count > report.bad_edges.size()) {
+        out << "     ... " << report.bad_edge_count - report.bad_edges.size() << " more missing predecessors\n";
+    }
+    if (report.bad_edge_count != 0) {
+        return;
+    }
+    if (!report.cycle.empty()) {
+        out << "  ❌ cycle: ";
+        list(report.cycle, " -> ");
+        out << " -> " << name(report.cycle.front()) << "\n";
+    }
+    if (report.unreachable_count != 0) {
+        out << "  ❌ " << report.unreachable_count << " unreachable node(s): ";
+        list(report.unreachable, ", ");
+        out << (report.unreachable_count > report.unreachable.size() ? ", ...\n" : "\n");
+    }
+    out << "  📊 " << report.levels << " levels, widest is level " << report.widest_level << " with "
+        << report.widest_level_size << " nodes; total cost " << report.total_cost << "\n";
+    out << "  🎯 critical path: cost " << report.critical_path_cost << ", " << report.critical_path.size()
+        << " nodes";
+    if (!report.critical_path.empty()) {
+        out << " (" << name(report.critical_path.front()) << " ... " << name(report.critical_path.back()) << ")";
+    }
+    out << "\n";
+}
+
+} // namespace dag
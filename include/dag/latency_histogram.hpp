@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*
+ * LATENCY HISTOGRAM - HDR-STYLE PERCENTILES FOR NODE TIMINGS
+ *
+ * Latencies are recorded in nanoseconds into log-linear buckets, as in
+ * HdrHistogram: values below 128 get one bucket each, and every power of two
+ * above that is split into 64 linear sub-buckets. Any recorded value is
+ * therefore reported with a relative error below 1/64 (~1.6%) over the whole
+ * range (1ns .. ~9.7 hours; larger values are clamped), while a histogram is
+ * a fixed 20 KB array no matter how many samples it holds.
+ *
+ * record() is a relaxed atomic increment, so worker threads record
+ * concurrently without locks. percentile() scans the buckets and should be
+ * called between runs.
+ *
+ * LatencyStats keeps three histograms per node of a graph and is accumulated
+ * across runs by GraphExecutor::set_latency_stats():
+ *
+ * - queue_wait: node became ready -> a worker started it,
+ * - run_time:   start -> end of the node's function,
+ * - end_to_end: start of run() -> node finished (or completed from the cache).
+ */
+
+namespace dag {
+
+class LatencyHistogram {
+private:
+    static constexpr int kSubBucketBits = 7;
+    static constexpr std::uint64_t kSubBuckets = 1ull << kSubBucketBits;  // 128
+    static constexpr std::uint64_t kHalfSubBuckets = kSubBuckets / 2;      // 64
+    static constexpr int kMaxShift = 38;
+    static constexpr std::uint64_t kMaxValue = (kSubBuckets << kMaxShift) - 1;
+    static constexpr std::size_t kBucketCount = kSubBuckets + kMaxShift * kHalfSubBuckets;
+
+    std::array<std::atomic<std::uint64_t>, kBucketCount> counts_{};
+    std::atomic<std::uint64_t> total_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+
+    static int bit_width(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return value == 0 ? 0 : 64 - __builtin_clzll(value);
+#else
+        int width = 0;
+        for (; value != 0; value >>= 1) {
+            ++width;
+        }
+        return width;
+#endif
+    }
+
+    static std::size_t bucket_of(std::uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<std::size_t>(value);
+        }
+        const int shift = bit_width(value) - kSubBucketBits;
+        return static_cast<std::size_t>(kSubBuckets + (shift - 1) * kHalfSubBuckets +
+                                        ((value >> shift) - kHalfSubBuckets));
+    }
+
+    // Largest value that falls into `bucket`
+    static std::uint64_t highest_in(std::size_t bucket) {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        const std::size_t offset = bucket - kSubBuckets;
+        const int shift = static_cast<int>(offset / kHalfSubBuckets) + 1;
+        const std::uint64_t sub = kHalfSubBuckets + offset % kHalfSubBuckets;
+        return ((sub + 1) << shift) - 1;
+    }
+
+public:
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(std::int64_t nanoseconds) {
+        const std::uint64_t value =
+            std::min<std::uint64_t>(static_cast<std::uint64_t>(std::max<std::int64_t>(nanoseconds, 0)), kMaxValue);
+        counts_[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+        total_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        std::uint64_t seen = max_.load(std::memory_order_relaxed);
+        while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Smallest recorded value (bucket upper bound) that at least `quantile`
+    // of the samples do not exceed, e.g. percentile(0.99) for p99
+    std::uint64_t percentile(double quantile) const {
+        const std::uint64_t total = count();
+        if (total == 0) {
+            return 0;
+        }
+        const auto rank = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(total))));
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+            seen += counts_[bucket].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return std::min(highest_in(bucket), max());
+            }
+        }
+        return max();
+    }
+
+    std::uint64_t count() const { return total_.load(std::memory_order_relaxed); }
+    std::uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    double mean() const {
+        const std::uint64_t total = count();
+        return total == 0 ? 0.0 : static_cast<double>(sum_.load(std::memory_order_relaxed)) / total;
+    }
+
+    void reset() {
+        for (auto& bucket : counts_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        total_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+};
+
+struct NodeLatency {
+    LatencyHistogram queue_wait;
+    LatencyHistogram run_time;
+    LatencyHistogram end_to_end;
+};
+
+class LatencyStats {
+private:
+    std::vector<std::unique_ptr<NodeLatency>> nodes_;
+    std::atomic<std::uint64_t> runs_{0};
+
+public:
+    // Grows to cover `node_count` nodes; existing samples are kept
+    void resize(std::size_t node_count) {
+        while (nodes_.size() < node_count) {
+            nodes_.push_back(std::make_unique<NodeLatency>());
+        }
+    }
+
+    void count_run() { runs_.fetch_add(1, std::memory_order_relaxed); }
+
+    std::uint64_t runs() const { return runs_.load(std::memory_order_relaxed); }
+    std::size_t size() const { return nodes_.size(); }
+    NodeLatency& node(std::size_t id) { return *nodes_[id]; }
+    const NodeLatency& node(std::size_t id) const { return *nodes_.at(id); }
+
+    void reset() {
+        for (auto& node : nodes_) {
+            node->queue_wait.reset();
+            node->run_time.reset();
+            node->end_to_end.reset();
+        }
+        runs_.store(0, std::memory_order_relaxed);
+    }
+};
+
+} // namespace dag
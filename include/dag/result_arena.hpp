@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+/*
+ * RESULT ARENA - PER-RUN NODE RESULT STORAGE
+ *
+ * One slot per node, laid out contiguously and indexed by node id. The slots
+ * are allocated once and reused by every run:
+ *
+ * - reset() starts a new run in O(1) by bumping the arena generation; a slot
+ *   only holds a value if it was written during the current generation,
+ * - values left over from an earlier run are destroyed lazily, when their
+ *   slot is written again (or when the arena is resized or destroyed),
+ * - different slots may be written concurrently from different threads; the
+ *   executor orders a slot's write before any read of it.
+ */
+
+namespace dag {
+
+template<typename Value>
+class ResultArena {
+private:
+    struct Slot {
+        alignas(Value) unsigned char storage[sizeof(Value)];
+        std::uint32_t generation = 0;
+        bool constructed = false;
+
+        Value* get() { return std::launder(reinterpret_cast<Value*>(storage)); }
+        const Value* get() const { return std::launder(reinterpret_cast<const Value*>(storage)); }
+
+        void destroy() {
+            if (constructed) {
+                get()->~Value();
+                constructed = false;
+            }
+        }
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t size_ = 0;
+    std::uint32_t generation_ = 1;
+
+    void destroy_all() {
+        for (std::size_t i = 0; i < size_; ++i) {
+            slots_[i].destroy();
+        }
+    }
+
+public:
+    ResultArena() = default;
+    explicit ResultArena(std::size_t size) { resize(size); }
+
+    ResultArena(const ResultArena&) = delete;
+    ResultArena& operator=(const ResultArena&) = delete;
+
+    ~ResultArena() { destroy_all(); }
+
+    // Reallocates only when the node count changes; always starts a new run
+    void resize(std::size_t size) {
+        if (size != size_) {
+            destroy_all();
+            slots_.reset(new Slot[size]);
+            size_ = size;
+        }
+        reset();
+    }
+
+    // Forgets every value of the current run in O(1)
+    void reset() {
+        if (generation_ == std::numeric_limits<std::uint32_t>::max()) {
+            destroy_all();
+            for (std::size_t i = 0; i < size_; ++i) {
+                slots_[i].generation = 0;
+            }
+            generation_ = 0;
+        }
+        ++generation_;
+    }
+
+    template<typename... Args>
+    Value& emplace(std::size_t id, Args&&... args) {
+        Slot& slot = slots_[id];
+        slot.destroy();
+        ::new (static_cast<void*>(slot.storage)) Value(std::forward<Args>(args)...);
+        slot.constructed = true;
+        slot.generation = generation_;
+        return *slot.get();
+    }
+
+    // Destroys the value of a slot before the end of the run
+    void release(std::size_t id) {
+        slots_[id].destroy();
+    }
+
+    bool has_value(std::size_t id) const {
+        const Slot& slot = slots_[id];
+        return slot.constructed && slot.generation == generation_;
+    }
+
+    const Value& operator[](std::size_t id) const { return *slots_[id].get(); }
+    Value& operator[](std::size_t id) { return *slots_[id].get(); }
+
+    const Value& at(std::size_t id) const {
+        if (id >= size_ || !has_value(id)) {
+            throw std::out_of_range("No result for node " + std::to_string(id) + " in the current run");
+        }
+        return (*this)[id];
+    }
+
+    std::size_t size() const { return size_; }
+};
+
+} // namespace dag
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+/*
+ * RESULT CACHE - CONTENT-ADDRESSED MEMOIZATION OF NODE RESULTS
+ *
+ * A node marked cacheable is a pure function of its inputs, so its result is
+ * fully determined by (task identity, input values). The cache maps that key
+ * to a copy of the result:
+ *
+ *     key = (graph id, node name, combine(hash(input 0), hash(input 1), ...))
+ *
+ * When a cacheable node becomes ready and its key is present, the executor
+ * copies the cached value into the result arena and completes the node on the
+ * spot - it is never handed to the scheduler. Sources have no inputs, so their
+ * key is the name alone.
+ *
+ * The cache has a memory budget in bytes; entries are charged the size
+ * reported by CacheOptions::value_bytes and the least recently used entries
+ * are evicted once the budget is exceeded. A single value larger than the
+ * whole budget is not cached. One cache may be shared by several executors and
+ * graphs; all operations are thread-safe. Keys carry TaskGraph::id(), so
+ * nodes of different graphs never share entries even if their names match
+ * (a copy of a graph is a different graph and starts cold).
+ *
+ * Input values are not stored, only their combined hash: two different input
+ * tuples of the same node whose hashes collide return each other's result.
+ * With a good 64-bit hash_value that takes billions of distinct inputs per
+ * node to become likely; a weak hash_value (e.g. one field of a struct) makes
+ * it a real risk.
+ */
+
+namespace dag {
+
+template<typename Value>
+struct CacheOptions {
+    std::size_t memory_budget = 64 * 1024 * 1024;
+
+    // Hash of one input value; equal values must hash equally. Defaults to
+    // std::hash<Value> when Value has one.
+    std::function<std::size_t(const Value&)> hash_value;
+
+    // Memory charged against the budget for one cached value
+    std::function<std::size_t(const Value&)> value_bytes = [](const Value&) {
+        return sizeof(Value);
+    };
+};
+
+struct CacheKey {
+    std::uint64_t graph = 0;  // TaskGraph::id()
+    std::string task;
+    std::size_t input_hash = 0;
+
+    bool operator==(const CacheKey& other) const {
+        return input_hash == other.input_hash && graph == other.graph && task == other.task;
+    }
+};
+
+struct CacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+    std::size_t entries = 0;
+    std::size_t bytes_used = 0;
+};
+
+template<typename Value>
+class ResultCache {
+private:
+    struct KeyHash {
+        std::size_t operator()(const CacheKey& key) const {
+            return std::hash<std::string>{}(key.task) ^ (key.input_hash * 0x9e3779b97f4a7c15ull) ^
+                   (key.graph * 0xc2b2ae3d27d4eb4full);
+        }
+    };
+
+    struct Entry {
+        CacheKey key;
+        Value value;
+        std::size_t bytes;
+    };
+
+    CacheOptions<Value> options_;
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;  // most recently used first
+    std::unordered_map<CacheKey, typename std::list<Entry>::iterator, KeyHash> index_;
+    CacheStats stats_;
+
+    void evict_to_budget() {
+        while (stats_.bytes_used > options_.memory_budget && !lru_.empty()) {
+            const Entry& victim = lru_.back();
+            stats_.bytes_used -= victim.bytes;
+            index_.erase(victim.key);
+            lru_.pop_back();
+            ++stats_.evictions;
+        }
+        stats_.entries = lru_.size();
+    }
+
+public:
+    explicit ResultCache(CacheOptions<Value> options = {})
+        : options_(std::move(options)) {
+        if (!options_.hash_value) {
+            if constexpr (std::is_invocable_v<std::hash<Value>, const Value&>) {
+                options_.hash_value = [](const Value& value) { return std::hash<Value>{}(value); };
+            } else {
+                throw std::invalid_argument("ResultCache needs CacheOptions::hash_value for this value type");
+            }
+        }
+    }
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // Folds the hash of one more input into a key's input hash
+    std::size_t combine(std::size_t seed, const Value& input) const {
+        return seed ^ (options_.hash_value(input) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+
+    // Copy of the cached value, refreshing its LRU position
+    std::optional<Value> find(const CacheKey& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++stats_.misses;
+            return std::nullopt;
+        }
+        lru_.splice(lru_.begin(), lru_, it->second);
+        ++stats_.hits;
+        return it->second->value;
+    }
+
+    void insert(CacheKey key, const Value& value) {
+        const std::size_t bytes = options_.value_bytes(value) + sizeof(Entry) + key.task.size();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (bytes > options_.memory_budget) {
+            return;
+        }
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            stats_.bytes_used -= it->second->bytes;
+            lru_.erase(it->second);
+            index_.erase(it);
+        }
+        lru_.push_front(Entry{std::move(key), value, bytes});
+        index_.emplace(lru_.front().key, lru_.begin());
+        stats_.bytes_used += bytes;
+        evict_to_budget();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index_.clear();
+        lru_.clear();
+        stats_.bytes_used = 0;
+        stats_.entries = 0;
+    }
+
+    void set_memory_budget(std::size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        options_.memory_budget = bytes;
+        evict_to_budget();
+    }
+
+    CacheStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+};
+
+} // namespace dag
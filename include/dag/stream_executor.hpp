@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dag_executor.hpp"
+#include "latency_histogram.hpp"
+#include "task_graph.hpp"
+#include "trace_recorder.hpp"
+
+/*
+ * STREAM EXECUTOR - MANY GRAPH INSTANCES IN FLIGHT
+ *
+ * A GraphExecutor runs one instance of a graph at a time: while the last
+ * nodes of instance i run, most of the pool sits idle even though the first
+ * nodes of instance i+1 could already start. A StreamExecutor accepts a
+ * stream of inputs, one graph instance each, and keeps up to `in_flight`
+ * instances running at once on the same scheduler:
+ *
+ *     instance 0:  [T1 T2 T3]──[T4 T5]──[T6]
+ *     instance 1:        [T1 T2 T3]──[T4 T5]──[T6]
+ *     instance 2:              [T1 T2 T3]──[T4 T5]──[T6]
+ *
+ * - every in-flight slot owns a GraphExecutor and its own copy of the graph,
+ *   built once by the GraphFactory; the graph reads the instance's input
+ *   through the accessor it is given,
+ * - submit() blocks while `queue_capacity` inputs are already waiting, so
+ *   memory is bounded by in_flight result arenas plus the queued inputs no
+ *   matter how fast inputs arrive,
+ * - each slot is driven by one thread that only waits for its run to finish;
+ *   the nodes themselves run on the scheduler,
+ * - results are handed to the ResultHandler, on the slot's thread, while the
+ *   slot's arena still holds them; a failed instance goes to the ErrorHandler
+ *   and the stream carries on.
+ *
+ * stats() reports sustained throughput (instances per second from the first
+ * submit to the last completion) and latency() the submit-to-result latency
+ * of every instance.
+ */
+
+namespace dag {
+
+struct StreamOptions {
+    unsigned in_flight = 4;           // graph instances running at once
+    std::size_t queue_capacity = 0;   // inputs waiting for a slot; 0 = in_flight
+    ExecutorOptions executor;         // for every slot's GraphExecutor
+};
+
+struct StreamStats {
+    std::uint64_t submitted = 0;
+    std::uint64_t completed = 0;
+    std::uint64_t failed = 0;
+    double elapsed_seconds = 0.0;  // first submit -> last finished instance
+    double dags_per_second = 0.0;  // finished instances (completed + failed) / elapsed
+};
+
+template<typename Input, typename Value>
+class StreamExecutor {
+public:
+    using InputRef = std::function<const Input&()>;
+    using GraphFactory = std::function<TaskGraph<Value>(InputRef input)>;
+    using ResultHandler = std::function<void(std::uint64_t sequence, const Input& input,
+                                             const ResultArena<Value>& results)>;
+    using ErrorHandler = std::function<void(std::uint64_t sequence, const Input& input, std::exception_ptr error)>;
+
+private:
+    struct Item {
+        std::uint64_t sequence;
+        Input input;
+        std::int64_t submit_ns;
+    };
+
+    struct Slot {
+        GraphExecutor<Value> executor;
+        TaskGraph<Value> graph;
+        std::optional<Item> item;  // the instance being run
+        std::thread thread;
+
+        explicit Slot(const ExecutorOptions& options) : executor(options) {}
+    };
+
+    using RunFn = std::function<const ResultArena<Value>&(GraphExecutor<Value>&, const TaskGraph<Value>&)>;
+
+    RunFn run_;
+    std::size_t queue_capacity_;
+    ResultHandler on_result_;
+    ErrorHandler on_error_;
+
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::condition_variable idle_;
+    std::deque<Item> queue_;
+    bool closed_ = false;
+    std::size_t running_ = 0;
+    StreamStats counts_;
+    std::int64_t first_submit_ns_ = 0;
+    std::int64_t last_done_ns_ = 0;
+
+    LatencyHistogram latency_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+
+    void serve(Slot& slot) {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                not_empty_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                slot.item.emplace(std::move(queue_.front()));
+                queue_.pop_front();
+                ++running_;
+            }
+            not_full_.notify_one();
+
+            const Item& item = *slot.item;
+            bool completed = true;
+            try {
+                const ResultArena<Value>& results = run_(slot.executor, slot.graph);
+                if (on_result_) {
+                    on_result_(item.sequence, item.input, results);
+                }
+            } catch (...) {
+                completed = false;
+                if (on_error_) {
+                    on_error_(item.sequence, item.input, std::current_exception());
+                }
+            }
+            const std::int64_t done_ns = steady_clock_ns();
+            latency_.record(done_ns - item.submit_ns);
+            slot.item.reset();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --running_;
+                ++(completed ? counts_.completed : counts_.failed);
+                last_done_ns_ = done_ns;
+                if (running_ == 0 && queue_.empty()) {
+                    idle_.notify_all();
+                }
+            }
+        }
+    }
+
+public:
+    // Builds one graph per slot with `factory` and starts the slot threads
+    template<typename Scheduler>
+    StreamExecutor(Scheduler scheduler, GraphFactory factory, StreamOptions options = {})
+        : run_([scheduler](GraphExecutor<Value>& executor, const TaskGraph<Value>& graph)
+                   -> const ResultArena<Value>& { return executor.run(graph, scheduler); })
+        , queue_capacity_(options.queue_capacity != 0 ? options.queue_capacity
+                                                      : std::max<std::size_t>(options.in_flight, 1)) {
+        if (options.in_flight == 0) {
+            throw std::invalid_argument("StreamExecutor needs at least one instance in flight");
+        }
+        for (unsigned i = 0; i < options.in_flight; ++i) {
+            auto slot = std::make_unique<Slot>(options.executor);
+            Slot* raw = slot.get();
+            slot->graph = factory([raw]() -> const Input& { return raw->item->input; });
+            slots_.push_back(std::move(slot));
+        }
+        try {
+            for (auto& slot : slots_) {
+                slot->thread = std::thread([this, raw = slot.get()] { serve(*raw); });
+            }
+        } catch (...) {
+            // The destructor will not run; a joinable std::thread destroyed
+            // with slots_ would terminate. The queue is empty, so the
+            // threads already started exit as soon as they see it closed.
+            close();
+            for (auto& slot : slots_) {
+                if (slot->thread.joinable()) {
+                    slot->thread.join();
+                }
+            }
+            throw;
+        }
+    }
+
+    // Finishes every instance already submitted
+    ~StreamExecutor() {
+        close();
+        for (auto& slot : slots_) {
+            slot->thread.join();
+        }
+    }
+
+    StreamExecutor(const StreamExecutor&) = delete;
+    StreamExecutor& operator=(const StreamExecutor&) = delete;
+
+    // Set before the first submit()
+    void set_result_handler(ResultHandler handler) { on_result_ = std::move(handler); }
+    void set_error_handler(ErrorHandler handler) { on_error_ = std::move(handler); }
+
+    // Queues one graph instance; blocks while the queue is full. Returns the
+    // instance's sequence number.
+    std::uint64_t submit(Input input) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || queue_.size() < queue_capacity_; });
+        if (closed_) {
+            throw std::logic_error("StreamExecutor::submit() after close()");
+        }
+        const std::int64_t now = steady_clock_ns();
+        if (counts_.submitted == 0) {
+            first_submit_ns_ = now;
+        }
+        const std::uint64_t sequence = counts_.submitted++;
+        queue_.push_back(Item{sequence, std::move(input), now});
+        lock.unlock();
+        not_empty_.notify_one();
+        return sequence;
+    }
+
+    // No more inputs; slots exit once the queue is drained
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    // Blocks until every submitted instance has finished
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return running_ == 0 && queue_.empty(); });
+    }
+
+    StreamStats stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        StreamStats stats = counts_;
+        if (stats.completed + stats.failed > 0) {
+            stats.elapsed_seconds = static_cast<double>(last_done_ns_ - first_submit_ns_) / 1e9;
+            if (stats.elapsed_seconds > 0.0) {
+                stats.dags_per_second = static_cast<double>(stats.completed + stats.failed) / stats.elapsed_seconds;
+            }
+        }
+        return stats;
+    }
+
+    // Submit-to-result latency of every finished instance, in nanoseconds
+    const LatencyHistogram& latency() const { return latency_; }
+
+    std::size_t in_flight() const { return slots_.size(); }
+};
+
+} // namespace dag
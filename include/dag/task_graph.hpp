@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unifex/any_sender_of.hpp>
+#include <unifex/inplace_stop_token.hpp>
+
+#include "result_arena.hpp"
+
+/*
+ * TASK GRAPH - STATIC DAG DESCRIPTION
+ *
+ * A TaskGraph describes *what* has to run: every node declares the nodes it
+ * depends on and the work it performs once all of them have produced a value.
+ * The graph is built once and can be executed any number of times by a
+ * GraphExecutor (see dag_executor.hpp).
+ *
+ * Nodes may only depend on nodes that were added before them, so every graph
+ * built through add_node() is acyclic by construction and node ids are
+ * already a topological order.
+ *
+ * Each node carries a cost estimate (any unit, e.g. expected milliseconds).
+ * Costs are only used for prioritisation: upward_ranks() returns, per node,
+ * the cost of the most expensive path from that node to the end of the graph.
+ *
+ * A node may also carry a deadline (set_timeout()), measured from the moment
+ * it becomes ready, and a TimeoutPolicy deciding what its consumers get if
+ * the deadline passes first, and a RetryPolicy (set_retry()) for transient
+ * failures.
+ *
+ * A node added with add_async_node() returns a sender instead of a value. Its
+ * work may wait on timers or I/O (see delay() in async_delay.hpp) without
+ * holding a worker; the node completes when the sender does.
+ *
+ * Every change to a graph gives it a new generation(), so an executor that
+ * ran it before notices and rebuilds what it derived from the old version.
+ *
+ * A node marked with set_inline() is glue - a sum, a field lookup - cheaper
+ * than a trip through the scheduler. Executors run it on whichever thread
+ * readies it instead of dispatching it to the pool.
+ */
+
+namespace dag {
+
+using NodeId = std::uint32_t;
+
+// Thrown by a node that gave up because its run was stopped
+class TaskCancelled : public std::runtime_error {
+public:
+    TaskCancelled() : std::runtime_error("Task cancelled: the run was stopped") {}
+};
+
+// What a node's consumers receive when the node misses its deadline
+enum class TimeoutPolicy {
+    Fail,          // the run fails with NodeTimeout
+    UseDefault,    // the value given to set_timeout()
+    UseLastValue   // the node's value from its last successful run, else Fail
+};
+
+class NodeTimeout : public std::runtime_error {
+public:
+    NodeTimeout(const std::string& node, std::chrono::milliseconds limit)
+        : std::runtime_error("Node " + node + " missed its deadline of " + std::to_string(limit.count()) + "ms") {}
+};
+
+class PipelineTimeout : public std::runtime_error {
+public:
+    explicit PipelineTimeout(std::chrono::milliseconds limit)
+        : std::runtime_error("Pipeline missed its deadline of " + std::to_string(limit.count()) + "ms") {}
+};
+
+// How often and how fast a failing node is re-run. Attempt k (k >= 1) waits
+//   min(initial_backoff * multiplier^(k-1), max_backoff) * (1 +/- jitter)
+// before re-running; the wait is a timer, not a blocked worker.
+struct RetryPolicy {
+    unsigned max_attempts = 1;  // 1 = no retry
+    std::chrono::milliseconds initial_backoff{10};
+    double multiplier = 2.0;
+    std::chrono::milliseconds max_backoff{1000};
+    double jitter = 0.2;        // fraction of the backoff, randomised both ways
+
+    // Whether a failure may be retried; empty retries every exception except
+    // TaskCancelled
+    std::function<bool(std::exception_ptr)> retryable;
+};
+
+// Retryable predicate accepting exceptions of type Exception (or derived)
+template<typename Exception>
+std::function<bool(std::exception_ptr)> retry_on() {
+    return [](std::exception_ptr error) {
+        try {
+            std::rethrow_exception(error);
+        } catch (const Exception&) {
+            return true;
+        } catch (...) {
+            return false;
+        }
+    };
+}
+
+// View over the values produced by a node's predecessors.
+// inputs[i] is the value of the i-th predecessor passed to add_node().
+//
+// - operator[] borrows: no copy, valid until the consuming node returns.
+// - take(i) hands out an owned value. It moves the value out of the arena when
+//   the caller is the only consumer of that input still running and the
+//   executor releases consumed results (ResultRetention::ReleaseConsumed);
+//   otherwise other readers may still need it and take() copies. A node with
+//   a RetryPolicy always gets copies, so a retry reads the values the failed
+//   attempt saw. Each input should be taken at most once per attempt.
+//
+// stop_token() is signalled when the run is abandoned (another node failed);
+// long-running nodes should poll it and give up early, e.g. by calling
+// throw_if_stop_requested().
+template<typename Value>
+class NodeInputs {
+private:
+    const std::vector<NodeId>& predecessors_;
+    ResultArena<Value>& results_;
+    // Consumers of each node that have not finished yet; null if values must
+    // be retained after the run
+    const std::atomic<std::uint32_t>* remaining_consumers_;
+    unifex::inplace_stop_token stop_token_;
+
+public:
+    NodeInputs(const std::vector<NodeId>& predecessors, ResultArena<Value>& results,
+               const std::atomic<std::uint32_t>* remaining_consumers = nullptr,
+               unifex::inplace_stop_token stop_token = {})
+        : predecessors_(predecessors), results_(results), remaining_consumers_(remaining_consumers),
+          stop_token_(stop_token) {}
+
+    std::size_t size() const { return predecessors_.size(); }
+    NodeId node_id(std::size_t index) const { return predecessors_.at(index); }
+
+    const Value& operator[](std::size_t index) const {
+        return results_[predecessors_.at(index)];
+    }
+
+    // True if take(index) will move instead of copy
+    bool is_last_consumer(std::size_t index) const {
+        return remaining_consumers_ != nullptr &&
+               remaining_consumers_[predecessors_.at(index)].load(std::memory_order_acquire) == 1;
+    }
+
+    Value take(std::size_t index) const {
+        if (is_last_consumer(index)) {
+            return std::move(results_[predecessors_[index]]);
+        }
+        return results_[predecessors_.at(index)];
+    }
+
+    unifex::inplace_stop_token stop_token() const { return stop_token_; }
+    bool stop_requested() const { return stop_token_.stop_requested(); }
+
+    void throw_if_stop_requested() const {
+        if (stop_token_.stop_requested()) {
+            throw TaskCancelled();
+        }
+    }
+};
+
+// A process-unique number that a copy does not inherit, so two live graphs
+// never share one; a move hands it over
+class GraphStamp {
+public:
+    GraphStamp() noexcept : value_(next()) {}
+    GraphStamp(const GraphStamp&) noexcept : value_(next()) {}
+    GraphStamp(GraphStamp&& other) noexcept : value_(other.value_) { other.value_ = next(); }
+    GraphStamp& operator=(const GraphStamp&) noexcept {
+        value_ = next();
+        return *this;
+    }
+    GraphStamp& operator=(GraphStamp&& other) noexcept {
+        value_ = other.value_;
+        other.value_ = next();
+        return *this;
+    }
+
+    std::uint64_t value() const { return value_; }
+
+private:
+    std::uint64_t value_;
+
+    static std::uint64_t next() noexcept {
+        static std::atomic<std::uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+};
+
+template<typename Value>
+class TaskGraph {
+public:
+    using TaskFn = std::function<Value(const NodeInputs<Value>&)>;
+    using AsyncTaskFn = std::function<unifex::any_sender_of<Value>(const NodeInputs<Value>&)>;
+
+    struct Node {
+        std::string name;
+        std::vector<NodeId> predecessors;
+        std::vector<NodeId> successors;
+        TaskFn fn;
+        AsyncTaskFn async_fn;  // set instead of fn for async nodes
+        double cost = 1.0;
+        bool cacheable = false;  // pure function of its inputs, see ResultCache
+        bool run_inline = false; // cheap: run on the thread that readies it
+
+        std::chrono::milliseconds timeout{0};  // 0 = no deadline
+        TimeoutPolicy on_timeout = TimeoutPolicy::Fail;
+        std::optional<Value> timeout_value;    // for TimeoutPolicy::UseDefault
+
+        RetryPolicy retry;
+    };
+
+    NodeId add_node(std::string name, std::vector<NodeId> predecessors, TaskFn fn, double cost = 1.0) {
+        const auto id = static_cast<NodeId>(nodes_.size());
+        for (NodeId pred : predecessors) {
+            if (pred >= id) {
+                throw std::invalid_argument("Node " + name + " depends on unknown node " + std::to_string(pred));
+            }
+        }
+        for (NodeId pred : predecessors) {
+            nodes_[pred].successors.push_back(id);
+        }
+        Node node;
+        node.name = std::move(name);
+        node.predecessors = std::move(predecessors);
+        node.fn = std::move(fn);
+        node.cost = cost;
+        nodes_.push_back(std::move(node));
+        touch();
+        return id;
+    }
+
+    // Like add_node(), but `fn` returns a sender of the node's value. The
+    // inputs stay valid until that sender completes.
+    NodeId add_async_node(std::string name, std::vector<NodeId> predecessors, AsyncTaskFn fn, double cost = 1.0) {
+        const NodeId id = add_node(std::move(name), std::move(predecessors), TaskFn(), cost);
+        nodes_[id].async_fn = std::move(fn);
+        touch();
+        return id;
+    }
+
+    // Declares that a node's result depends only on its name and input values,
+    // so an executor with a ResultCache may reuse it instead of running it
+    void set_cacheable(NodeId id, bool cacheable = true) {
+        nodes_.at(id).cacheable = cacheable;
+        touch();
+    }
+
+    // Declares a node too cheap to be worth a scheduler hop; it then runs on
+    // the thread that finished its last predecessor. Keep such nodes short:
+    // that thread may be a pool worker, the timer thread or run()'s caller.
+    void set_inline(NodeId id, bool run_inline = true) {
+        nodes_.at(id).run_inline = run_inline;
+        touch();
+    }
+
+    // Bounds the time from the node becoming ready to its value being
+    // available; past the deadline the node is stopped and resolved by policy
+    void set_timeout(NodeId id, std::chrono::milliseconds limit, TimeoutPolicy policy = TimeoutPolicy::Fail,
+                     std::optional<Value> value = std::nullopt) {
+        if (policy == TimeoutPolicy::UseDefault && !value) {
+            throw std::invalid_argument("TimeoutPolicy::UseDefault needs a value for node " + nodes_.at(id).name);
+        }
+        Node& node = nodes_.at(id);
+        timed_nodes_ -= node.timeout.count() > 0 ? 1 : 0;
+        timed_nodes_ += limit.count() > 0 ? 1 : 0;
+        node.timeout = limit;
+        node.on_timeout = policy;
+        node.timeout_value = std::move(value);
+        touch();
+    }
+
+    // True if any node has a deadline
+    bool has_timeouts() const { return timed_nodes_ != 0; }
+
+    void set_retry(NodeId id, RetryPolicy policy) {
+        if (policy.max_attempts == 0) {
+            throw std::invalid_argument("RetryPolicy needs at least one attempt for node " + nodes_.at(id).name);
+        }
+        Node& node = nodes_.at(id);
+        retried_nodes_ -= node.retry.max_attempts > 1 ? 1 : 0;
+        retried_nodes_ += policy.max_attempts > 1 ? 1 : 0;
+        node.retry = std::move(policy);
+        touch();
+    }
+
+    // True if any node may be retried
+    bool has_retries() const { return retried_nodes_ != 0; }
+
+    // Upward rank (remaining critical-path cost) of every node:
+    //   rank(n) = cost(n) + max(rank(s) for s in successors(n))
+    std::vector<double> upward_ranks() const {
+        std::vector<double> ranks(nodes_.size(), 0.0);
+        for (std::size_t i = nodes_.size(); i-- > 0;) {
+            double longest_tail = 0.0;
+            for (NodeId succ : nodes_[i].successors) {
+                longest_tail = std::max(longest_tail, ranks[succ]);
+            }
+            ranks[i] = nodes_[i].cost + longest_tail;
+        }
+        return ranks;
+    }
+
+    void reserve(std::size_t nodes) { nodes_.reserve(nodes); }
+
+    std::size_t size() const { return nodes_.size(); }
+
+    // Identifies this graph (not a copy of it) for as long as it lives
+    std::uint64_t id() const { return identity_.value(); }
+
+    // Process-unique like id(), but renewed by every change to the graph;
+    // executors key what they derive from a graph (shape, ranks, ...) on it
+    std::uint64_t generation() const { return generation_.value(); }
+
+    const Node& node(NodeId id) const { return nodes_.at(id); }
+    const std::vector<Node>& nodes() const { return nodes_; }
+
+private:
+    std::vector<Node> nodes_;
+    std::size_t timed_nodes_ = 0;
+    std::size_t retried_nodes_ = 0;
+    GraphStamp identity_;
+    GraphStamp generation_;
+
+    void touch() { generation_ = GraphStamp(); }
+};
+
+} // namespace dag
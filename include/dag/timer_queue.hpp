@@ -0,0 +1,161 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+ * TIMER QUEUE - DEADLINES WITHOUT BLOCKED WORKERS
+ *
+ * One dedicated thread sleeps on a condition variable until the earliest
+ * pending deadline and then runs that timer's callback. Waiting for a
+ * deadline therefore never occupies a pool thread:
+ *
+ *     auto id = timers.schedule_after(150ms, [] { ... });   // any thread
+ *     timers.cancel(id);                                    // if no longer needed
+ *
+ * - timers live in a binary min-heap ordered by deadline; cancelled entries
+ *   are dropped lazily when they reach the top,
+ * - callbacks run on the timer thread, one at a time, and should only do
+ *   short work such as completing a node or handing a job to a scheduler,
+ * - cancel() returns true if the callback will never run; if the callback is
+ *   running right now it waits for it to finish (unless called from inside a
+ *   callback) and returns false, so after cancel() returns the callback is
+ *   not touching anything the caller is about to destroy,
+ * - try_cancel() never waits: a caller that the running callback may itself
+ *   be waiting for (a lock, a stop callback) uses it and leaves the callback
+ *   to notice it lost.
+ *
+ * shared() is a process-wide instance, started on first use.
+ */
+
+namespace dag {
+
+class TimerQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = std::uint64_t;
+
+private:
+    struct Entry {
+        Clock::time_point deadline;
+        TimerId id;
+
+        // Earliest deadline on top of the heap; equal deadlines fire in order
+        bool operator<(const Entry& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : id > other.id;
+        }
+    };
+
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable done_cv_;
+    std::priority_queue<Entry> heap_;
+    std::unordered_map<TimerId, std::function<void()>> callbacks_;
+    TimerId next_id_ = 1;
+    TimerId running_ = 0;  // id of the callback being run, 0 if none
+    bool stopping_ = false;
+    std::thread thread_;
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            if (heap_.empty()) {
+                wake_cv_.wait(lock);
+                continue;
+            }
+            const Entry next = heap_.top();
+            auto callback = callbacks_.find(next.id);
+            if (callback == callbacks_.end()) {
+                heap_.pop();  // cancelled
+                continue;
+            }
+            if (Clock::now() < next.deadline) {
+                wake_cv_.wait_until(lock, next.deadline);
+                continue;
+            }
+
+            heap_.pop();
+            std::function<void()> fn = std::move(callback->second);
+            callbacks_.erase(callback);
+            running_ = next.id;
+            lock.unlock();
+            fn();
+            lock.lock();
+            running_ = 0;
+            done_cv_.notify_all();
+        }
+    }
+
+public:
+    TimerQueue() : thread_([this] { loop(); }) {}
+
+    ~TimerQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_cv_.notify_one();
+        thread_.join();
+    }
+
+    TimerQueue(const TimerQueue&) = delete;
+    TimerQueue& operator=(const TimerQueue&) = delete;
+
+    static TimerQueue& shared() {
+        static TimerQueue timers;
+        return timers;
+    }
+
+    TimerId schedule_at(Clock::time_point deadline, std::function<void()> callback) {
+        TimerId id;
+        bool earliest;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            id = next_id_++;
+            callbacks_.emplace(id, std::move(callback));
+            earliest = heap_.empty() || deadline < heap_.top().deadline;
+            heap_.push(Entry{deadline, id});
+        }
+        if (earliest) {
+            wake_cv_.notify_one();
+        }
+        return id;
+    }
+
+    template<typename Rep, typename Period>
+    TimerId schedule_after(std::chrono::duration<Rep, Period> delay, std::function<void()> callback) {
+        return schedule_at(Clock::now() + std::chrono::duration_cast<Clock::duration>(delay), std::move(callback));
+    }
+
+    bool cancel(TimerId id) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (callbacks_.erase(id) != 0) {
+            return true;
+        }
+        if (std::this_thread::get_id() != thread_.get_id()) {
+            done_cv_.wait(lock, [this, id] { return running_ != id; });
+        }
+        return false;
+    }
+
+    // Like cancel(), but returns false at once if the callback is running
+    bool try_cancel(TimerId id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return callbacks_.erase(id) != 0;
+    }
+
+    std::size_t pending() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return callbacks_.size();
+    }
+};
+
+} // namespace dag
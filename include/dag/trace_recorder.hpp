@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "task_graph.hpp"
+
+/*
+ * TRACE RECORDER - PER-NODE TIMELINE IN CHROME TRACE FORMAT
+ *
+ * Records, for every node an executor runs, when it became ready (enqueue),
+ * when a worker picked it up (start), when it finished (end) and which
+ * thread ran it. The gap between enqueue and start is the time the node spent
+ * waiting in the scheduler's queue.
+ *
+ * Recording is cheap: each thread appends to its own buffer, found through a
+ * thread_local pointer, so workers never contend on a lock or share cache
+ * lines. The only lock is taken once per thread, the first time it records.
+ *
+ * write_chrome_trace() emits trace-event JSON that chrome://tracing and
+ * ui.perfetto.dev open directly:
+ *
+ * - one row per thread with a slice per node run; an async node appears on
+ *   the row of the worker that started it, not of the thread (often the
+ *   timer thread) that completed its sender,
+ * - an async "queued" slice per node from enqueue to start,
+ * - nodes completed from a ResultCache appear as zero-length slices.
+ *
+ * Export and clear() must not overlap with a run that records into the same
+ * recorder.
+ */
+
+namespace dag {
+
+// Timestamp used for node timings: steady_clock nanoseconds
+inline std::int64_t steady_clock_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Times are relative to the creation of the recorder
+struct TraceEvent {
+    NodeId node;
+    std::uint32_t thread;  // row of the thread the node ran on
+    std::int64_t enqueue_ns;
+    std::int64_t start_ns;
+    std::int64_t end_ns;
+    bool cached;
+};
+
+class TraceRecorder {
+private:
+    struct ThreadBuffer {
+        std::uint32_t index;
+        std::thread::id thread;
+        std::vector<TraceEvent> events;
+    };
+
+    // Per-thread lookup; the serial tells recorders apart even if one is
+    // destroyed and another is allocated at the same address
+    struct ThreadSlot {
+        std::uint64_t serial = 0;
+        ThreadBuffer* buffer = nullptr;
+    };
+
+    static std::uint64_t next_serial() {
+        static std::atomic<std::uint64_t> serial{0};
+        return serial.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    const std::uint64_t serial_ = next_serial();
+    const std::int64_t origin_ns_ = steady_clock_ns();
+
+    std::mutex buffers_mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+
+    ThreadBuffer& local_buffer() {
+        thread_local ThreadSlot slot;
+        if (slot.serial != serial_) {
+            const auto thread = std::this_thread::get_id();
+            std::lock_guard<std::mutex> lock(buffers_mutex_);
+            auto it = std::find_if(buffers_.begin(), buffers_.end(),
+                                   [thread](const auto& buffer) { return buffer->thread == thread; });
+            if (it == buffers_.end()) {
+                auto index = static_cast<std::uint32_t>(buffers_.size());
+                buffers_.push_back(std::make_unique<ThreadBuffer>(ThreadBuffer{index, thread, {}}));
+                buffers_.back()->events.reserve(256);
+                it = std::prev(buffers_.end());
+            }
+            slot.serial = serial_;
+            slot.buffer = it->get();
+        }
+        return *slot.buffer;
+    }
+
+    static void write_escaped(std::ostream& out, const std::string& text) {
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out << ' ';
+            } else {
+                out << c;
+            }
+        }
+    }
+
+public:
+    static constexpr std::uint32_t kCallingThread = ~std::uint32_t(0);
+
+    TraceRecorder() = default;
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // Row of the calling thread in the trace
+    std::uint32_t current_thread() { return local_buffer().index; }
+
+    // Timestamps are steady_clock_ns() values. The event is shown on the row
+    // of `thread` (a current_thread() value taken when the node started),
+    // by default the calling thread's.
+    void record(NodeId node, std::int64_t enqueue_ns, std::int64_t start_ns, std::int64_t end_ns,
+                bool cached = false, std::uint32_t thread = kCallingThread) {
+        ThreadBuffer& buffer = local_buffer();
+        buffer.events.push_back(TraceEvent{node, thread == kCallingThread ? buffer.index : thread,
+                                           enqueue_ns - origin_ns_, start_ns - origin_ns_, end_ns - origin_ns_,
+                                           cached});
+    }
+
+    // All events recorded so far, ordered by start time
+    std::vector<TraceEvent> events() {
+        std::vector<TraceEvent> all;
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        for (const auto& buffer : buffers_) {
+            all.insert(all.end(), buffer->events.begin(), buffer->events.end());
+        }
+        std::sort(all.begin(), all.end(), [](const TraceEvent& a, const TraceEvent& b) {
+            return a.start_ns < b.start_ns;
+        });
+        return all;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        for (auto& buffer : buffers_) {
+            buffer->events.clear();
+        }
+    }
+
+    // Chrome trace-event JSON; node names are taken from `graph`
+    template<typename Value>
+    void write_chrome_trace(std::ostream& out, const TaskGraph<Value>& graph) {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        const auto us = [](std::int64_t ns) { return static_cast<double>(ns) / 1000.0; };
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(3);
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        const auto separator = [&out, &first]() {
+            out << (first ? "" : ",\n");
+            first = false;
+        };
+
+        std::uint64_t flow_id = 0;
+        for (const auto& buffer : buffers_) {
+            std::ostringstream thread_name;
+            thread_name << "thread " << buffer->index << " (" << buffer->thread << ")";
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->index
+                << ",\"args\":{\"name\":\"" << thread_name.str() << "\"}}";
+
+            for (const auto& event : buffer->events) {
+                const std::string& name = graph.node(event.node).name;
+
+                separator();
+                out << "{\"name\":\"";
+                write_escaped(out, name);
+                out << "\",\"cat\":\"" << (event.cached ? "cached" : "node") << "\",\"ph\":\"X\",\"pid\":1"
+                    << ",\"tid\":" << event.thread << ",\"ts\":" << us(event.start_ns)
+                    << ",\"dur\":" << us(event.end_ns - event.start_ns)
+                    << ",\"args\":{\"node\":" << event.node
+                    << ",\"queued_us\":" << us(event.start_ns - event.enqueue_ns) << "}}";
+
+                ++flow_id;
+                for (const char* phase : {"b", "e"}) {
+                    separator();
+                    out << "{\"name\":\"";
+                    write_escaped(out, name);
+                    out << " queued\",\"cat\":\"queue\",\"ph\":\"" << phase << "\",\"id\":" << flow_id
+                        << ",\"pid\":1,\"tid\":" << event.thread
+                        << ",\"ts\":" << us(phase[0] == 'b' ? event.enqueue_ns : event.start_ns) << "}";
+                }
+            }
+        }
+        out << "\n]}\n";
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+};
+
+} // namespace dag
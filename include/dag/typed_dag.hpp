@@ -0,0 +1,528 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <unifex/get_stop_token.hpp>
+#include <unifex/receiver_concepts.hpp>
+#include <unifex/scheduler_concepts.hpp>
+#include <unifex/sender_concepts.hpp>
+#include <unifex/tag_invoke.hpp>
+
+/*
+ * TYPED DAG - COMPILE-TIME GRAPH LOWERED TO ONE SENDER
+ *
+ * The runtime TaskGraph passes values between nodes as a type-erased Value and
+ * checks edge types when a node reads its inputs. A TypedGraph instead encodes
+ * the whole graph in its type:
+ *
+ *     auto graph = dag::make_typed_graph(
+ *         dag::typed_node<>(&load_a),         // 0: () -> double
+ *         dag::typed_node<>(&load_b),         // 1: () -> std::string
+ *         dag::typed_node<0, 1>(&combine));   // 2: (double, const std::string&) -> double
+ *
+ * - node I may only depend on nodes with a smaller index (acyclic by type),
+ * - each node's result type is deduced from its callable and the result types
+ *   of its dependencies, and a callable that cannot accept them is a compile
+ *   error rather than a bad_variant_access at run time,
+ * - lower(scheduler) produces a single sender. Its operation state holds the
+ *   results (a tuple of std::optional), a pending-dependency counter per node
+ *   and one scheduler operation per node, all connected up front: no per-node
+ *   heap allocation and no intermediate sync_wait.
+ *
+ * Scheduling is dependency-driven, like GraphExecutor's: a node is scheduled
+ * as soon as its own dependencies have finished, by the thread that finished
+ * the last of them. There are no level barriers - in the example above a slow
+ * load_a does not hold back anything that needs only load_b.
+ *
+ * A node whose callable returns void only orders its consumers: they run
+ * after it but are not passed an argument for it, and its slot in the result
+ * holds std::monostate.
+ *
+ * A node declared with typed_async_node() returns a sender instead of a
+ * value, e.g. a delay() followed by the computation; the value it completes
+ * with is the node's result. The worker that called the callable moves on
+ * right away, and the node's consumers are scheduled from whichever thread
+ * completes the sender. Such a sender receives the run's stop token.
+ *
+ * The sender completes with std::tuple<T0, T1, ...> holding every node's
+ * value. The first exception a node throws stops further nodes from being
+ * scheduled, and the sender completes with it once the running ones have
+ * returned; likewise with set_done() if the receiver's stop token is
+ * signalled or the scheduler declines a node. The sender refers to the
+ * graph's callables, so the graph must outlive it.
+ */
+
+namespace dag {
+
+template<typename Fn, std::size_t... Deps>
+struct TypedNode {
+    Fn fn;
+
+    using dependencies = std::index_sequence<Deps...>;
+    static constexpr bool async = false;
+};
+
+template<typename Fn, std::size_t... Deps>
+struct TypedAsyncNode {
+    Fn fn;
+
+    using dependencies = std::index_sequence<Deps...>;
+    static constexpr bool async = true;
+};
+
+// Declares a node whose callable takes the values of nodes Deps... (by index)
+template<std::size_t... Deps, typename Fn>
+TypedNode<std::decay_t<Fn>, Deps...> typed_node(Fn&& fn) {
+    return {std::forward<Fn>(fn)};
+}
+
+// Like typed_node(), but the callable returns a sender of the node's value
+template<std::size_t... Deps, typename Fn>
+TypedAsyncNode<std::decay_t<Fn>, Deps...> typed_async_node(Fn&& fn) {
+    return {std::forward<Fn>(fn)};
+}
+
+namespace detail {
+
+template<typename NodeList, typename Node, typename Deps = typename Node::dependencies>
+struct typed_node_result;
+
+// What node D passes its consumers: nothing if it returns void
+template<typename NodeList, std::size_t D>
+struct typed_argument {
+    using result = typed_node_result<NodeList, std::tuple_element_t<D, NodeList>>;
+    using type = std::conditional_t<result::returns_void, std::tuple<>, std::tuple<const typename result::type&>>;
+};
+
+template<typename Fn, typename Arguments>
+struct typed_invoke;
+
+template<typename Fn, typename... Args>
+struct typed_invoke<Fn, std::tuple<Args...>> {
+    static constexpr bool valid = std::is_invocable_v<Fn, Args...>;
+    using type = std::invoke_result_t<Fn, Args...>;
+};
+
+// The single value a sender completes with, void if none
+template<typename... Values>
+struct typed_sender_value {
+    static_assert(sizeof...(Values) <= 1, "typed_async_node sender must complete with at most one value");
+    using type = void;
+};
+
+template<typename Value>
+struct typed_sender_value<Value> {
+    using type = Value;
+};
+
+template<typename... Alternatives>
+struct typed_sender_alternative {
+    static_assert(sizeof...(Alternatives) == 1, "typed_async_node sender must have exactly one set_value signature");
+};
+
+template<typename Alternative>
+struct typed_sender_alternative<Alternative> {
+    using type = typename Alternative::type;
+};
+
+template<bool Async, typename Invoked>
+struct typed_produced {
+    using type = Invoked;
+};
+
+template<typename Sender>
+struct typed_produced<true, Sender> {
+    using type = typename unifex::sender_traits<std::decay_t<Sender>>::template value_types<
+        typed_sender_alternative, typed_sender_value>::type;
+};
+
+template<typename NodeList, typename Node, std::size_t... Deps>
+struct typed_node_result<NodeList, Node, std::index_sequence<Deps...>> {
+    using Fn = decltype(Node::fn);
+    using arguments = decltype(std::tuple_cat(std::declval<typename typed_argument<NodeList, Deps>::type>()...));
+
+    static_assert(typed_invoke<const Fn&, arguments>::valid,
+                  "typed_node callable cannot be invoked with the result types of its dependencies");
+
+    // The callable's result: the value, or for an async node its sender
+    using invoked = typename typed_invoke<const Fn&, arguments>::type;
+    using raw = typename typed_produced<Node::async, invoked>::type;
+
+    static constexpr bool returns_void = std::is_void_v<raw>;
+    using type = std::conditional_t<returns_void, std::monostate, std::decay_t<raw>>;
+};
+
+template<typename NodeList, std::size_t I>
+using typed_value_t = typename typed_node_result<NodeList, std::tuple_element_t<I, NodeList>>::type;
+
+template<std::size_t I, std::size_t... Deps>
+constexpr bool dependencies_precede(std::index_sequence<Deps...>) {
+    return ((Deps < I) && ... && true);
+}
+
+// Dependencies and consumers of every node, as plain index tables
+template<std::size_t Size>
+struct TypedEdges {
+    std::array<std::uint32_t, Size> in_degree{};
+    std::array<std::size_t, Size> out_degree{};
+    std::array<std::array<std::size_t, Size>, Size> successors{};
+
+    template<std::size_t... Deps>
+    constexpr void add(std::size_t node, std::index_sequence<Deps...>) {
+        for (std::size_t dep : {Deps...}) {
+            ++in_degree[node];
+            successors[dep][out_degree[dep]++] = node;
+        }
+    }
+
+    constexpr void add(std::size_t, std::index_sequence<>) {}
+};
+
+} // namespace detail
+
+template<typename... Nodes>
+class TypedGraph {
+public:
+    using node_list = std::tuple<Nodes...>;
+    static constexpr std::size_t size = sizeof...(Nodes);
+
+    template<std::size_t I>
+    using value_type = detail::typed_value_t<node_list, I>;
+
+private:
+    template<std::size_t... Is>
+    static constexpr bool acyclic(std::index_sequence<Is...>) {
+        return (detail::dependencies_precede<Is>(
+                    typename std::tuple_element_t<Is, node_list>::dependencies{}) && ...);
+    }
+
+    static_assert(size > 0, "TypedGraph needs at least one node");
+    static_assert(acyclic(std::index_sequence_for<Nodes...>{}),
+                  "typed_node may only depend on nodes declared before it");
+
+    template<std::size_t I>
+    using node_result = detail::typed_node_result<node_list, std::tuple_element_t<I, node_list>>;
+
+    template<std::size_t I>
+    static constexpr bool returns_void = node_result<I>::returns_void;
+
+    template<std::size_t I>
+    static constexpr bool is_async = std::tuple_element_t<I, node_list>::async;
+
+    template<std::size_t I>
+    using sender_type = std::decay_t<typename node_result<I>::invoked>;
+
+    template<std::size_t... Is>
+    static constexpr detail::TypedEdges<size> compute_edges(std::index_sequence<Is...>) {
+        detail::TypedEdges<size> edges{};
+        (edges.add(Is, typename std::tuple_element_t<Is, node_list>::dependencies{}), ...);
+        return edges;
+    }
+
+    static constexpr detail::TypedEdges<size> edges = compute_edges(std::index_sequence_for<Nodes...>{});
+
+    template<std::size_t... Is>
+    static std::tuple<std::optional<value_type<Is>>...> slots_for(std::index_sequence<Is...>);
+
+    template<std::size_t... Is>
+    static std::tuple<value_type<Is>...> values_for(std::index_sequence<Is...>);
+
+public:
+    // Per-node storage carried by the lowered sender's operation
+    using slots_type = decltype(slots_for(std::index_sequence_for<Nodes...>{}));
+    using result_type = decltype(values_for(std::index_sequence_for<Nodes...>{}));
+
+    explicit TypedGraph(Nodes... nodes)
+        : nodes_(std::move(nodes)...) {}
+
+private:
+    node_list nodes_;
+
+    template<std::size_t D>
+    static auto argument(const slots_type& slots) {
+        if constexpr (returns_void<D>) {
+            return std::tuple<>();
+        } else {
+            return std::tuple<const value_type<D>&>(*std::get<D>(slots));
+        }
+    }
+
+    // The node's value, or for an async node the sender of it
+    template<std::size_t I, std::size_t... Deps>
+    decltype(auto) call_node(const slots_type& slots, std::index_sequence<Deps...>) const {
+        return std::apply(std::get<I>(nodes_).fn, std::tuple_cat(argument<Deps>(slots)...));
+    }
+
+    template<std::size_t I>
+    void invoke_node(slots_type& slots) const {
+        using deps = typename std::tuple_element_t<I, node_list>::dependencies;
+        if constexpr (returns_void<I>) {
+            call_node<I>(slots, deps{});
+            std::get<I>(slots).emplace();
+        } else {
+            std::get<I>(slots).emplace(call_node<I>(slots, deps{}));
+        }
+    }
+
+    template<std::size_t... Is>
+    static result_type take_values(slots_type& slots, std::index_sequence<Is...>) {
+        return result_type(std::move(*std::get<Is>(slots))...);
+    }
+
+    // One run of the graph. Every node has a scheduler operation, connected
+    // when the run is; a node's operation is started once its pending count
+    // reaches zero and runs the node on the scheduler's thread. An async
+    // node's sender is connected there, into a slot of its own.
+    template<typename Scheduler, typename Receiver>
+    class Operation {
+    private:
+        // Failure and stop handling shared by the receivers below
+        template<std::size_t I>
+        struct ReceiverBase {
+            Operation* op;
+
+            void set_error(std::exception_ptr error) && noexcept {
+                op->fail(std::move(error));
+                op->finish_node(I);
+            }
+            template<typename Error>
+            void set_error(Error&& error) && noexcept {
+                op->fail(std::make_exception_ptr(std::forward<Error>(error)));
+                op->finish_node(I);
+            }
+            void set_done() && noexcept {
+                op->stopped_.store(true, std::memory_order_relaxed);
+                op->finish_node(I);
+            }
+
+            // The run's receiver's stop token, so senders such as delay() stop with it
+            auto stop_token() const noexcept { return unifex::get_stop_token(op->receiver_); }
+
+            friend auto tag_invoke(unifex::tag_t<unifex::get_stop_token>, const ReceiverBase& receiver) noexcept {
+                return receiver.stop_token();
+            }
+        };
+
+        // Completes the node's schedule() on the worker that runs it
+        template<std::size_t I>
+        struct NodeReceiver : ReceiverBase<I> {
+            void set_value() && noexcept { this->op->template run_node<I>(); }
+        };
+
+        // Completes an async node with the value of its sender
+        template<std::size_t I>
+        struct ValueReceiver : ReceiverBase<I> {
+            template<typename... Values>
+            void set_value(Values&&... values) && noexcept {
+                try {
+                    std::get<I>(this->op->slots_).emplace(std::forward<Values>(values)...);
+                } catch (...) {
+                    this->op->fail(std::current_exception());
+                }
+                this->op->finish_node(I);
+            }
+        };
+
+        template<std::size_t I>
+        struct AsyncOperation {
+            unifex::connect_result_t<sender_type<I>, ValueReceiver<I>> op;
+
+            template<typename Connect>
+            explicit AsyncOperation(Connect&& connect) : op(connect()) {}
+        };
+
+        template<std::size_t I>
+        using AsyncSlot = std::conditional_t<is_async<I>, std::optional<AsyncOperation<I>>, std::monostate>;
+
+        template<std::size_t I>
+        struct NodeOperation {
+            unifex::connect_result_t<unifex::schedule_result_t<Scheduler>, NodeReceiver<I>> op;
+
+            explicit NodeOperation(Operation* parent)
+                : op(unifex::connect(unifex::schedule(parent->scheduler_), NodeReceiver<I>{{parent}})) {}
+        };
+
+        template<std::size_t... Is>
+        static std::tuple<NodeOperation<Is>...> node_operations_for(std::index_sequence<Is...>);
+
+        template<std::size_t... Is>
+        static std::tuple<AsyncSlot<Is>...> async_slots_for(std::index_sequence<Is...>);
+
+        template<std::size_t... Is>
+        static constexpr std::array<void (*)(Operation&), size> starters_for(std::index_sequence<Is...>) {
+            return {&Operation::start_at<Is>...};
+        }
+
+        using NodeOperations = decltype(node_operations_for(std::index_sequence_for<Nodes...>{}));
+        using AsyncSlots = decltype(async_slots_for(std::index_sequence_for<Nodes...>{}));
+
+        const TypedGraph* graph_;
+        Scheduler scheduler_;
+        Receiver receiver_;
+        slots_type slots_;
+        std::array<std::atomic<std::uint32_t>, size> pending_;
+        std::atomic<std::size_t> outstanding_{0};  // started nodes not finished yet
+        std::atomic<bool> failed_{false};
+        std::atomic<bool> stopped_{false};
+        std::mutex error_mutex_;
+        std::exception_ptr error_;
+        NodeOperations nodes_;
+        AsyncSlots async_;
+
+        template<std::size_t... Is>
+        Operation(const TypedGraph* graph, Scheduler scheduler, Receiver&& receiver, std::index_sequence<Is...>)
+            : graph_(graph)
+            , scheduler_(std::move(scheduler))
+            , receiver_(std::move(receiver))
+            , nodes_((static_cast<void>(Is), this)...) {
+            for (std::size_t i = 0; i < size; ++i) {
+                pending_[i].store(edges.in_degree[i], std::memory_order_relaxed);
+            }
+        }
+
+        template<std::size_t I>
+        static void start_at(Operation& self) {
+            unifex::start(std::get<I>(self.nodes_).op);
+        }
+
+        // Node indices are only known at run time here; dispatch to start_at<I>
+        void start_node(std::size_t node) noexcept {
+            static constexpr std::array<void (*)(Operation&), size> starters =
+                starters_for(std::index_sequence_for<Nodes...>{});
+            starters[node](*this);
+        }
+
+        template<std::size_t I>
+        void run_node() noexcept {
+            if (!failed_.load(std::memory_order_relaxed) && !stopped_.load(std::memory_order_relaxed)) {
+                try {
+                    if constexpr (is_async<I>) {
+                        auto& slot = std::get<I>(async_).emplace([this] {
+                            using deps = typename std::tuple_element_t<I, node_list>::dependencies;
+                            return unifex::connect(graph_->template call_node<I>(slots_, deps{}),
+                                                   ValueReceiver<I>{{this}});
+                        });
+                        unifex::start(slot.op);
+                        return;  // ValueReceiver finishes the node
+                    } else {
+                        graph_->template invoke_node<I>(slots_);
+                    }
+                } catch (...) {
+                    fail(std::current_exception());
+                }
+            }
+            finish_node(I);
+        }
+
+        void fail(std::exception_ptr error) noexcept {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            if (!error_) {
+                error_ = std::move(error);
+            }
+            failed_.store(true, std::memory_order_relaxed);
+        }
+
+        // Schedules the consumers this node was the last dependency of, then
+        // completes the run if nothing else is running
+        void finish_node(std::size_t node) noexcept {
+            if (unifex::get_stop_token(receiver_).stop_requested()) {
+                stopped_.store(true, std::memory_order_relaxed);
+            }
+            if (!failed_.load(std::memory_order_relaxed) && !stopped_.load(std::memory_order_relaxed)) {
+                for (std::size_t k = 0; k < edges.out_degree[node]; ++k) {
+                    const std::size_t succ = edges.successors[node][k];
+                    if (pending_[succ].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        outstanding_.fetch_add(1, std::memory_order_relaxed);
+                        start_node(succ);
+                    }
+                }
+            }
+            if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                complete();
+            }
+        }
+
+        void complete() noexcept {
+            if (failed_.load(std::memory_order_relaxed)) {
+                unifex::set_error(std::move(receiver_), std::move(error_));
+            } else if (stopped_.load(std::memory_order_relaxed)) {
+                unifex::set_done(std::move(receiver_));
+            } else {
+                try {
+                    unifex::set_value(std::move(receiver_), take_values(slots_, std::index_sequence_for<Nodes...>{}));
+                } catch (...) {
+                    unifex::set_error(std::move(receiver_), std::current_exception());
+                }
+            }
+        }
+
+    public:
+        Operation(const TypedGraph* graph, Scheduler scheduler, Receiver&& receiver)
+            : Operation(graph, std::move(scheduler), std::move(receiver), std::index_sequence_for<Nodes...>{}) {}
+
+        Operation(const Operation&) = delete;
+        Operation& operator=(const Operation&) = delete;
+
+        void start() noexcept {
+            // Counted before any source starts, so an early finisher cannot
+            // complete the run while others are still being started
+            std::size_t sources = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                sources += edges.in_degree[i] == 0 ? 1 : 0;
+            }
+            outstanding_.store(sources, std::memory_order_relaxed);
+            for (std::size_t i = 0; i < size; ++i) {
+                if (edges.in_degree[i] == 0) {
+                    start_node(i);
+                }
+            }
+        }
+    };
+
+    template<typename Scheduler>
+    class Sender {
+    private:
+        const TypedGraph* graph_;
+        Scheduler scheduler_;
+
+    public:
+        template<template<typename...> class Variant, template<typename...> class Tuple>
+        using value_types = Variant<Tuple<result_type>>;
+
+        template<template<typename...> class Variant>
+        using error_types = Variant<std::exception_ptr>;
+
+        static constexpr bool sends_done = true;
+
+        Sender(const TypedGraph* graph, Scheduler scheduler) : graph_(graph), scheduler_(std::move(scheduler)) {}
+
+        template<typename Receiver>
+        Operation<Scheduler, std::remove_cv_t<std::remove_reference_t<Receiver>>> connect(Receiver&& receiver) const {
+            return Operation<Scheduler, std::remove_cv_t<std::remove_reference_t<Receiver>>>(
+                graph_, scheduler_, std::forward<Receiver>(receiver));
+        }
+    };
+
+public:
+    template<typename Scheduler>
+    Sender<Scheduler> lower(Scheduler scheduler) const {
+        return Sender<Scheduler>(this, std::move(scheduler));
+    }
+};
+
+template<typename... Nodes>
+TypedGraph<Nodes...> make_typed_graph(Nodes... nodes) {
+    return TypedGraph<Nodes...>(std::move(nodes)...);
+}
+
+} // namespace dag
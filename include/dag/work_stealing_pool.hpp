@@ -0,0 +1,576 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <unifex/receiver_concepts.hpp>
+
+#include "cpu_topology.hpp"
+
+/*
+ * WORK-STEALING POOL - NO SHARED QUEUE ON THE HOT PATH
+ *
+ * unifex::static_thread_pool funnels every schedule() through one queue, so
+ * a fan-out of many short nodes has all workers contending on the same lock.
+ * WorkStealingPool gives every worker its own deque instead and models the
+ * same scheduler concept, so it drops in wherever a static_thread_pool
+ * scheduler is used:
+ *
+ *     dag::WorkStealingPool pool{4};
+ *     executor.run(graph, pool.get_scheduler());
+ *     unifex::sync_wait(unifex::schedule(pool.get_scheduler()) | unifex::then(...));
+ *
+ * - work scheduled from a worker goes to that worker's LIFO slot; whatever
+ *   was in the slot moves to the bottom of its Chase-Lev deque. A successor
+ *   made ready by a finishing node therefore runs next on the same worker,
+ *   while its data is still in cache,
+ * - a worker runs its LIFO slot, then pops its own deque (newest first),
+ *   then checks the injection queue, then steals the oldest task of a
+ *   randomly chosen victim, its LIFO slot last. After kLifoLimit tasks in a
+ *   row from its LIFO slot it looks at its deque and the injection queue
+ *   first, so two tasks that keep scheduling each other cannot starve them,
+ * - work scheduled from outside the pool goes to a mutex-protected injection
+ *   queue, which every worker also polls every kInjectionInterval tasks so
+ *   that a busy pool cannot starve it,
+ * - a worker that finds nothing after a few steal rounds sleeps on a
+ *   condition variable; pushing work wakes one sleeper, also when it only
+ *   fills an empty LIFO slot - its owner may be busy for a long time, and
+ *   thieves take from the slot too,
+ * - operation states are the queue entries (intrusive), so scheduling does
+ *   not allocate beyond the occasional deque growth.
+ *
+ * WorkerPlacement pins workers to CPUs, in CpuTopology::placement_order()
+ * (node by node, physical cores before SMT siblings), optionally restricted
+ * to a CPU set:
+ *
+ *     dag::WorkerPlacement placement;
+ *     placement.pin = true;
+ *     placement.cpus = {0, 1, 2, 3};    // empty: every CPU the process may use
+ *     dag::WorkStealingPool pool{4, placement};
+ *
+ * Each worker allocates its deque and counters itself, after pinning, so
+ * first-touch page placement puts them on the worker's NUMA node. A pinned
+ * worker steals from workers on its own node before crossing to another.
+ *
+ * Like static_thread_pool, the destructor runs the work still queued before
+ * joining the workers.
+ */
+
+namespace dag {
+
+struct WorkStealingStats {
+    std::uint64_t executed = 0;  // tasks run
+    std::uint64_t lifo = 0;      // ...taken from the worker's own LIFO slot
+    std::uint64_t stolen = 0;    // ...taken from another worker
+    std::uint64_t injected = 0;  // ...taken from the injection queue
+};
+
+struct WorkerPlacement {
+    bool pin = false;       // bind every worker to one CPU
+    std::vector<int> cpus;  // CPUs to use when pinning; empty = all allowed
+};
+
+class WorkStealingPool {
+private:
+    struct Task {
+        Task* next = nullptr;  // injection queue link
+        void (*execute)(Task*) noexcept = nullptr;
+    };
+
+    // Chase-Lev deque (Chase & Lev 2005, orderings after Le et al. 2013):
+    // the owner pushes and pops at the bottom, thieves take from the top.
+    // Buffers replaced by growth stay alive until the deque is destroyed,
+    // since a thief may still be reading from one.
+    class WorkDeque {
+    private:
+        struct Buffer {
+            std::int64_t capacity;
+            std::unique_ptr<std::atomic<Task*>[]> slots;
+
+            explicit Buffer(std::int64_t size)
+                : capacity(size)
+                , slots(new std::atomic<Task*>[static_cast<std::size_t>(size)]) {}
+
+            Task* get(std::int64_t index) const {
+                return slots[static_cast<std::size_t>(index & (capacity - 1))].load(std::memory_order_relaxed);
+            }
+
+            void put(std::int64_t index, Task* task) {
+                slots[static_cast<std::size_t>(index & (capacity - 1))].store(task, std::memory_order_relaxed);
+            }
+        };
+
+        alignas(64) std::atomic<std::int64_t> top_{0};
+        alignas(64) std::atomic<std::int64_t> bottom_{0};
+        std::atomic<Buffer*> buffer_;
+        std::vector<std::unique_ptr<Buffer>> buffers_;  // owner only
+
+        Buffer* grow(Buffer* old, std::int64_t top, std::int64_t bottom) {
+            auto bigger = std::make_unique<Buffer>(old->capacity * 2);
+            for (std::int64_t i = top; i < bottom; ++i) {
+                bigger->put(i, old->get(i));
+            }
+            Buffer* raw = bigger.get();
+            buffers_.push_back(std::move(bigger));
+            buffer_.store(raw, std::memory_order_release);
+            return raw;
+        }
+
+    public:
+        explicit WorkDeque(std::int64_t capacity = 256) {
+            buffers_.push_back(std::make_unique<Buffer>(capacity));
+            buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+        }
+
+        // Owner only
+        void push(Task* task) {
+            const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+            const std::int64_t top = top_.load(std::memory_order_acquire);
+            Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+            if (bottom - top > buffer->capacity - 1) {
+                buffer = grow(buffer, top, bottom);
+            }
+            buffer->put(bottom, task);
+            bottom_.store(bottom + 1, std::memory_order_seq_cst);
+        }
+
+        // Owner only; newest first
+        Task* pop() {
+            const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+            Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+            bottom_.store(bottom, std::memory_order_seq_cst);
+            std::int64_t top = top_.load(std::memory_order_seq_cst);
+            if (top > bottom) {
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            Task* task = buffer->get(bottom);
+            if (top == bottom) {
+                // Last task: race the thieves for it
+                if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed)) {
+                    task = nullptr;
+                }
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+            }
+            return task;
+        }
+
+        // Any thread; oldest first. nullptr if empty or another thread won.
+        Task* steal() {
+            std::int64_t top = top_.load(std::memory_order_seq_cst);
+            const std::int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+            if (top >= bottom) {
+                return nullptr;
+            }
+            Task* task = buffer_.load(std::memory_order_acquire)->get(top);
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return task;
+        }
+
+        bool empty() const {
+            return bottom_.load(std::memory_order_seq_cst) <= top_.load(std::memory_order_seq_cst);
+        }
+    };
+
+    struct alignas(64) Worker {
+        WorkStealingPool* pool;
+        WorkDeque deque;
+        std::atomic<Task*> lifo_slot{nullptr};
+        std::minstd_rand rng;  // victim selection, owner only
+        unsigned lifo_streak = 0;  // tasks run from lifo_slot in a row, owner only
+        std::atomic<std::uint64_t> executed{0};
+        std::atomic<std::uint64_t> lifo{0};
+        std::atomic<std::uint64_t> stolen{0};
+        std::atomic<std::uint64_t> injected{0};
+        int cpu = -1;                   // -1 if not pinned
+        int node = 0;
+        std::vector<Worker*> same_node;  // preferred victims, owner only
+
+        Worker(WorkStealingPool* owner, unsigned seed) : pool(owner), rng(seed) {}
+
+        void count(std::atomic<std::uint64_t>& counter) {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+    static constexpr unsigned kInjectionInterval = 61;
+    static constexpr unsigned kStealRounds = 4;
+    static constexpr unsigned kLifoLimit = 3;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    std::mutex startup_mutex_;
+    std::condition_variable startup_cv_;
+    std::size_t started_ = 0;
+    bool startup_failed_ = false;  // a worker thread could not be created
+
+    std::mutex injection_mutex_;
+    Task* injection_head_ = nullptr;
+    Task* injection_tail_ = nullptr;
+    std::atomic<std::size_t> injected_{0};
+
+    std::mutex park_mutex_;
+    std::condition_variable park_cv_;
+    std::atomic<unsigned> sleepers_{0};
+    unsigned wakeups_ = 0;  // guarded by park_mutex_
+    bool stopping_ = false;  // guarded by park_mutex_
+
+    static Worker*& current_worker() {
+        static thread_local Worker* worker = nullptr;
+        return worker;
+    }
+
+    void enqueue(Task* task) {
+        Worker* self = current_worker();
+        if (self != nullptr && self->pool == this) {
+            Task* displaced = self->lifo_slot.exchange(task, std::memory_order_seq_cst);
+            if (displaced != nullptr) {
+                self->deque.push(displaced);
+            }
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(injection_mutex_);
+                task->next = nullptr;
+                (injection_tail_ != nullptr ? injection_tail_->next : injection_head_) = task;
+                injection_tail_ = task;
+            }
+            injected_.fetch_add(1, std::memory_order_seq_cst);
+        }
+        wake_one();
+    }
+
+    Task* pop_injected() {
+        if (injected_.load(std::memory_order_relaxed) == 0) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(injection_mutex_);
+        Task* task = injection_head_;
+        if (task != nullptr) {
+            injection_head_ = task->next;
+            if (injection_head_ == nullptr) {
+                injection_tail_ = nullptr;
+            }
+            injected_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    Task* steal_from(Worker& self, Worker& victim) {
+        Task* task = victim.deque.steal();
+        if (task == nullptr && victim.lifo_slot.load(std::memory_order_relaxed) != nullptr) {
+            task = victim.lifo_slot.exchange(nullptr, std::memory_order_seq_cst);
+        }
+        if (task != nullptr) {
+            self.count(self.stolen);
+        }
+        return task;
+    }
+
+    Task* steal(Worker& self) {
+        const std::size_t count = workers_.size();
+        for (unsigned round = 0; round < kStealRounds; ++round) {
+            const std::size_t near = self.same_node.size();
+            const std::size_t near_start = near != 0 ? self.rng() % near : 0;
+            for (std::size_t i = 0; i < near; ++i) {
+                if (Task* task = steal_from(self, *self.same_node[(near_start + i) % near])) {
+                    return task;
+                }
+            }
+            const std::size_t start = self.rng() % count;
+            for (std::size_t i = 0; i < count; ++i) {
+                Worker& victim = *workers_[(start + i) % count];
+                if (&victim == &self) {
+                    continue;
+                }
+                if (Task* task = steal_from(self, victim)) {
+                    return task;
+                }
+            }
+            if (Task* task = pop_injected()) {
+                self.count(self.injected);
+                return task;
+            }
+            std::this_thread::yield();
+        }
+        return nullptr;
+    }
+
+    Task* next_task(Worker& self, unsigned& ticks) {
+        if (++ticks % kInjectionInterval == 0) {
+            if (Task* task = pop_injected()) {
+                self.count(self.injected);
+                return task;
+            }
+        }
+        if (self.lifo_streak < kLifoLimit) {
+            if (Task* task = self.lifo_slot.exchange(nullptr, std::memory_order_seq_cst)) {
+                ++self.lifo_streak;
+                self.count(self.lifo);
+                return task;
+            }
+        }
+        self.lifo_streak = 0;
+        if (Task* task = self.deque.pop()) {
+            return task;
+        }
+        if (Task* task = pop_injected()) {
+            self.count(self.injected);
+            return task;
+        }
+        // Over the limit with nothing else queued: the slot after all
+        if (Task* task = self.lifo_slot.exchange(nullptr, std::memory_order_seq_cst)) {
+            self.lifo_streak = 1;
+            self.count(self.lifo);
+            return task;
+        }
+        return steal(self);
+    }
+
+    bool work_available() const {
+        if (injected_.load(std::memory_order_seq_cst) != 0) {
+            return true;
+        }
+        for (const auto& worker : workers_) {
+            if (!worker->deque.empty() || worker->lifo_slot.load(std::memory_order_seq_cst) != nullptr) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void wake_one() {
+        if (sleepers_.load(std::memory_order_seq_cst) == 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(park_mutex_);
+            if (wakeups_ >= sleepers_.load(std::memory_order_relaxed)) {
+                return;
+            }
+            ++wakeups_;
+        }
+        park_cv_.notify_one();
+    }
+
+    // Returns false once the pool is stopping and no work is left
+    bool park() {
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        // Announced before the last look, so a producer that pushes after
+        // it either sees the sleeper or is seen by it
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        if (work_available()) {
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (stopping_) {
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        park_cv_.wait(lock, [this] { return stopping_ || wakeups_ > 0; });
+        if (wakeups_ > 0) {
+            --wakeups_;
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void run(Worker& self) {
+        current_worker() = &self;
+        unsigned ticks = 0;
+        for (;;) {
+            Task* task = next_task(self, ticks);
+            if (task == nullptr) {
+                if (!park()) {
+                    return;
+                }
+                continue;
+            }
+            self.count(self.executed);
+            task->execute(task);
+        }
+    }
+
+    void start_worker(std::size_t index, int cpu, int node, unsigned seed) {
+        if (cpu >= 0 && !CpuTopology::pin_current_thread(cpu)) {
+            cpu = -1;
+        }
+        // Allocated by the (pinned) worker itself so that first touch puts its
+        // deque and counters on its NUMA node
+        auto worker = std::make_unique<Worker>(this, seed);
+        worker->cpu = cpu;
+        worker->node = node;
+        Worker& self = *worker;
+        {
+            std::unique_lock<std::mutex> lock(startup_mutex_);
+            workers_[index] = std::move(worker);
+            if (++started_ == workers_.size()) {
+                startup_cv_.notify_all();
+            }
+            startup_cv_.wait(lock, [this] { return started_ == workers_.size() || startup_failed_; });
+            if (startup_failed_) {
+                return;
+            }
+        }
+        if (self.cpu >= 0) {
+            for (const auto& other : workers_) {
+                if (other.get() != &self && other->cpu >= 0 && other->node == self.node) {
+                    self.same_node.push_back(other.get());
+                }
+            }
+        }
+        run(self);
+    }
+
+public:
+    class scheduler;
+
+    template<typename Receiver>
+    class operation : private Task {
+    private:
+        WorkStealingPool* pool_;
+        Receiver receiver_;
+
+        static void execute_impl(Task* task) noexcept {
+            auto& self = *static_cast<operation*>(task);
+            unifex::set_value(std::move(self.receiver_));
+        }
+
+    public:
+        template<typename R>
+        operation(WorkStealingPool* pool, R&& receiver)
+            : pool_(pool)
+            , receiver_(std::forward<R>(receiver)) {
+            this->execute = &execute_impl;
+        }
+
+        operation(const operation&) = delete;
+        operation& operator=(const operation&) = delete;
+
+        void start() noexcept { pool_->enqueue(this); }
+    };
+
+    class schedule_sender {
+    private:
+        WorkStealingPool* pool_;
+
+    public:
+        template<template<typename...> class Variant, template<typename...> class Tuple>
+        using value_types = Variant<Tuple<>>;
+
+        template<template<typename...> class Variant>
+        using error_types = Variant<>;
+
+        static constexpr bool sends_done = false;  // a scheduled task always runs
+
+        explicit schedule_sender(WorkStealingPool* pool) : pool_(pool) {}
+
+        template<typename Receiver>
+        operation<std::remove_cv_t<std::remove_reference_t<Receiver>>> connect(Receiver&& receiver) const {
+            return operation<std::remove_cv_t<std::remove_reference_t<Receiver>>>(
+                pool_, std::forward<Receiver>(receiver));
+        }
+    };
+
+    class scheduler {
+    private:
+        WorkStealingPool* pool_;
+
+    public:
+        explicit scheduler(WorkStealingPool* pool) : pool_(pool) {}
+
+        schedule_sender schedule() const noexcept { return schedule_sender(pool_); }
+
+        friend bool operator==(scheduler a, scheduler b) noexcept { return a.pool_ == b.pool_; }
+        friend bool operator!=(scheduler a, scheduler b) noexcept { return a.pool_ != b.pool_; }
+    };
+
+    explicit WorkStealingPool(unsigned threads = std::max(1u, std::thread::hardware_concurrency()),
+                              const WorkerPlacement& placement = {}) {
+        threads = std::max(threads, 1u);
+        CpuTopology topology;
+        std::vector<int> cpus;
+        if (placement.pin) {
+            topology = CpuTopology::detect();
+            cpus = topology.placement_order(placement.cpus);
+        }
+
+        // Workers fill their own slots and wait for each other before running,
+        // so the pool is complete before any of them steals or is returned
+        workers_.resize(threads);
+        std::random_device seed;
+        try {
+            for (unsigned i = 0; i < threads; ++i) {
+                const int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+                const int node = cpu >= 0 ? topology.node_of(cpu) : 0;
+                threads_.emplace_back([this, i, cpu, node, worker_seed = seed()] {
+                    start_worker(i, cpu, node, worker_seed);
+                });
+            }
+        } catch (...) {
+            // The destructor will not run; release the workers already
+            // waiting for the rest and join them before threads_ goes
+            {
+                std::lock_guard<std::mutex> lock(startup_mutex_);
+                startup_failed_ = true;
+            }
+            startup_cv_.notify_all();
+            for (auto& thread : threads_) {
+                thread.join();
+            }
+            throw;
+        }
+        std::unique_lock<std::mutex> lock(startup_mutex_);
+        startup_cv_.wait(lock, [this] { return started_ == workers_.size(); });
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(park_mutex_);
+            stopping_ = true;
+        }
+        park_cv_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    scheduler get_scheduler() noexcept { return scheduler(this); }
+
+    std::size_t size() const { return workers_.size(); }
+
+    // CPU each worker is pinned to, -1 for a worker that floats
+    std::vector<int> worker_cpus() const {
+        std::vector<int> cpus;
+        for (const auto& worker : workers_) {
+            cpus.push_back(worker->cpu);
+        }
+        return cpus;
+    }
+
+    WorkStealingStats stats() const {
+        WorkStealingStats total;
+        for (const auto& worker : workers_) {
+            total.executed += worker->executed.load(std::memory_order_relaxed);
+            total.lifo += worker->lifo.load(std::memory_order_relaxed);
+            total.stolen += worker->stolen.load(std::memory_order_relaxed);
+            total.injected += worker->injected.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+};
+
+} // namespace dag
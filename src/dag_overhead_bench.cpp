@@ -0,0 +1,208 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <unifex/static_thread_pool.hpp>
+#include <dag/dag_executor.hpp>
+#include <dag/graph_generators.hpp>
+#include <dag/graph_validation.hpp>
+#include <dag/work_stealing_pool.hpp>
+
+/*
+ * DAG OVERHEAD BENCHMARK - SCHEDULING COST AND SCALING BY GRAPH SHAPE
+ *
+ * Generates wide, deep, random, diamond-lattice and fork-join graphs (see
+ * graph_generators.hpp) of the same size and node cost, and runs each of them
+ * on pools of 1, 2, 4, ... up to N threads. Per shape and thread count it
+ * reports:
+ *
+ * - makespan: median wall-clock time of a run,
+ * - speedup: makespan on 1 thread / makespan on t threads,
+ * - efficiency: the best possible makespan on t threads - max(critical path,
+ *   total work / t), from the measured cost of a node - over the makespan;
+ *   100% is a perfect schedule with free dispatch,
+ * - ns/node: worker time not spent in node work (dispatch, synchronisation,
+ *   idling) per node, i.e. (t * makespan - total work) / nodes. On one thread
+ *   this is the executor's pure per-node overhead.
+ *
+ * Nodes spin instead of sleeping, so their cost is real CPU time and the
+ * numbers only mean something with no more threads than cores. With a cost of
+ * 0 every node is empty and the makespan is all overhead. A final table lists
+ * the speedup curves side by side.
+ *
+ * Usage: dag_overhead_bench [max-threads=cores] [nodes=4096] [cost-us=10]
+ *                           [repetitions=5] [static|stealing]
+ */
+
+using BenchGraph = dag::TaskGraph<int>;
+
+// ===== NODE WORK =====
+
+void spin_for(double cost_us) {
+    const auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(static_cast<long>(cost_us * 1000));
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+BenchGraph::TaskFn make_spin_work(double cost_us) {
+    return [cost_us](const dag::NodeInputs<int>& inputs) {
+        spin_for(cost_us);
+        return static_cast<int>(inputs.size());
+    };
+}
+
+// Median time `nodes` back-to-back node bodies take with no scheduler at all
+double serial_work_ms(std::size_t nodes, double cost_us, int repetitions) {
+    std::vector<double> samples;
+    for (int r = 0; r < repetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < nodes; ++i) {
+            spin_for(cost_us);
+        }
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// ===== SHAPES =====
+
+struct Shape {
+    std::string name;
+    BenchGraph graph;
+    dag::GraphReport report;
+    double work_ms = 0.0;            // all node bodies, run back to back
+    std::vector<double> makespan_ms;  // per thread count
+};
+
+std::vector<Shape> make_shapes(std::size_t nodes, double cost_us) {
+    const BenchGraph::TaskFn work = make_spin_work(cost_us);
+    const double cost = cost_us > 0 ? cost_us : 1.0;  // uniform either way; ranks need it nonzero
+    const std::size_t side = std::max<std::size_t>(2, static_cast<std::size_t>(std::sqrt(static_cast<double>(nodes))));
+    const std::size_t fork_width = 32;
+
+    std::vector<Shape> shapes;
+    shapes.push_back({"wide", dag::make_wide_graph<int>(nodes > 2 ? nodes - 2 : 1, work, cost), {}, 0.0, {}});
+    shapes.push_back({"deep", dag::make_deep_graph<int>(nodes, work, cost), {}, 0.0, {}});
+    shapes.push_back({"random", dag::make_random_graph<int>(nodes, 3, 64, 7, work, cost), {}, 0.0, {}});
+    shapes.push_back({"diamond lattice", dag::make_diamond_lattice<int>(side, side, work, cost), {}, 0.0, {}});
+    shapes.push_back({"fork-join x32",
+                      dag::make_fork_join_graph<int>(std::max<std::size_t>(1, nodes / (fork_width + 1)), fork_width,
+                                                     work, cost),
+                      {}, 0.0, {}});
+    for (Shape& shape : shapes) {
+        shape.report = dag::validate_graph(shape.graph);
+    }
+    return shapes;
+}
+
+// ===== MEASUREMENT =====
+
+template<typename Scheduler>
+double median_makespan_ms(const BenchGraph& graph, Scheduler scheduler, int repetitions) {
+    dag::GraphExecutor<int> executor;
+    executor.run(graph, scheduler);  // warm-up: counters, arenas and ranks at full size
+    std::vector<double> samples;
+    for (int i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        executor.run(graph, scheduler);
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+double run_on_pool(const BenchGraph& graph, unsigned threads, bool stealing, int repetitions) {
+    if (stealing) {
+        dag::WorkStealingPool pool{threads};
+        return median_makespan_ms(graph, pool.get_scheduler(), repetitions);
+    }
+    unifex::static_thread_pool pool{threads};
+    return median_makespan_ms(graph, pool.get_scheduler(), repetitions);
+}
+
+void print_row(const Shape& shape, std::size_t index, unsigned threads) {
+    const double makespan = shape.makespan_ms[index];
+    const double nodes = static_cast<double>(shape.graph.size());
+    const double critical_ms = shape.report.total_cost > 0
+                                   ? shape.work_ms * shape.report.critical_path_cost / shape.report.total_cost
+                                   : 0.0;
+    const double bound = std::max(critical_ms, shape.work_ms / threads);
+    const double lost_ns = (threads * makespan - shape.work_ms) * 1e6 / nodes;
+
+    std::cout << "  " << std::setw(7) << threads
+              << std::setw(14) << std::fixed << std::setprecision(2) << makespan
+              << std::setw(11) << shape.makespan_ms[0] / makespan << "x"
+              << std::setw(12) << std::setprecision(0) << (makespan > 0 ? bound / makespan * 100.0 : 0.0) << "%"
+              << std::setw(11) << lost_ns << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned max_threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : cores;
+    const long nodes = argc > 2 ? std::atol(argv[2]) : 4096;
+    const double cost_us = argc > 3 ? std::atof(argv[3]) : 10.0;
+    const int repetitions = argc > 4 ? std::atoi(argv[4]) : 5;
+    const std::string pool_kind = argc > 5 ? argv[5] : "static";
+    if (max_threads == 0 || nodes < 4 || cost_us < 0 || repetitions <= 0 ||
+        (pool_kind != "static" && pool_kind != "stealing")) {
+        std::cerr << "Usage: " << argv[0] << " [max-threads] [nodes] [cost-us] [repetitions] [static|stealing]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::cout << "=== DAG OVERHEAD BENCHMARK: SCHEDULING COST BY GRAPH SHAPE ===" << std::endl;
+    std::cout << "~" << nodes << " nodes of " << cost_us << "us spin work, " << pool_kind << " pool, 1.."
+              << max_threads << " threads (" << cores << " cores), repetitions: " << repetitions
+              << " (median makespan reported)" << std::endl;
+
+    std::vector<Shape> shapes = make_shapes(static_cast<std::size_t>(nodes), cost_us);
+    for (Shape& shape : shapes) {
+        shape.work_ms = serial_work_ms(shape.graph.size(), cost_us, repetitions);
+
+        std::cout << "\n=== " << shape.name << ": " << shape.report.nodes << " nodes, " << shape.report.edges
+                  << " edges, " << shape.report.levels << " levels, widest " << shape.report.widest_level_size
+                  << " ===" << std::endl;
+        std::cout << "  🧩 " << std::fixed << std::setprecision(2) << shape.work_ms << "ms of node work, "
+                  << shape.report.critical_path.size() << " nodes on the critical path" << std::endl;
+        std::cout << "  " << std::setw(7) << "threads" << std::setw(14) << "makespan ms" << std::setw(12) << "speedup"
+                  << std::setw(13) << "efficiency" << std::setw(11) << "ns/node" << std::endl;
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+        for (std::size_t i = 0; i < thread_counts.size(); ++i) {
+            shape.makespan_ms.push_back(run_on_pool(shape.graph, thread_counts[i], pool_kind == "stealing", repetitions));
+            print_row(shape, i, thread_counts[i]);
+        }
+    }
+
+    std::cout << "\n=== SPEEDUP CURVES (makespan on 1 thread / makespan on t threads) ===" << std::endl;
+    std::cout << "  " << std::left << std::setw(18) << "graph" << std::right;
+    for (unsigned t : thread_counts) {
+        std::cout << std::setw(8) << ("t=" + std::to_string(t));
+    }
+    std::cout << std::endl;
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+    for (const Shape& shape : shapes) {
+        std::cout << "  " << std::left << std::setw(18) << shape.name << std::right;
+        for (double makespan : shape.makespan_ms) {
+            std::cout << std::setw(7) << std::setprecision(2) << shape.makespan_ms[0] / makespan << "x";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "💡 efficiency = max(critical path, work / threads) / makespan; ns/node = worker" << std::endl;
+    std::cout << "   time not spent in node work, per node. deep cannot scale; wide and fork-join" << std::endl;
+    std::cout << "   show dispatch and barrier cost, the lattice how fast a wavefront ramps up." << std::endl;
+    return 0;
+}
@@ -0,0 +1,719 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <memory>
+#include <unifex/static_thread_pool.hpp>
+#include <dag/cpu_topology.hpp>
+#include <dag/dag_executor.hpp>
+#include <dag/graph_file.hpp>
+#include <dag/stream_executor.hpp>
+#include <dag/work_stealing_pool.hpp>
+
+/*
+ * DAG SCHEDULING BENCHMARK - FIFO vs CRITICAL-PATH PRIORITY
+ *
+ * Builds synthetic wide DAGs whose width is well above the pool size, runs
+ * each of them with both dispatch policies and compares the makespan
+ * (wall-clock time from first dispatch to last completion).
+ *
+ * Node cost is simulated with sleep_for (like ITask::simulate_work), so the
+ * numbers are meaningful even when the pool has more threads than the machine
+ * has cores. Costs are in milliseconds.
+ *
+ * A second section runs chains that pass large buffers between nodes and
+ * compares peak live result memory with ResultRetention::KeepAll and
+ * ResultRetention::ReleaseConsumed. A third section counts buffer
+ * allocations and copies made while passing values along edges, comparing
+ * borrowed inputs (inputs[i]) and moved-out inputs (inputs.take(i)) with
+ * copying them.
+ *
+ * A fifth section runs fan-out graphs of microsecond nodes on
+ * unifex::static_thread_pool and on dag::WorkStealingPool. Nodes that short
+ * make handing work to the pool the bottleneck, which is where the two
+ * differ. The work-stealing pool is run a second time with its workers
+ * pinned to CPUs (WorkerPlacement), node by node.
+ *
+ * A sixth section runs the same kind of microsecond graphs with and without
+ * chain fusion (ExecutorOptions::fuse_chains), i.e. with every edge a
+ * scheduler round-trip or with single-consumer edges run inline.
+ *
+ * A seventh section runs graphs made only of nanosecond glue nodes with every
+ * node dispatched, with every node marked inline (TaskGraph::set_inline())
+ * and with nodes classified as inline from measured run times
+ * (ExecutorOptions::inline_below).
+ *
+ * The last section streams many instances of a small diamond-shaped pipeline
+ * through a StreamExecutor and reports sustained throughput (DAGs/sec) and
+ * per-instance latency for 1, 2, 4 and 8 instances in flight.
+ *
+ * Given a graph compiled by dag_compile, a final section maps it, builds a
+ * TaskGraph from it and runs it with both dispatch policies. Node kinds are
+ * sleep, spin and glue; see graphs/request_pipeline.dag.
+ *
+ * Usage: dag_scheduling_bench [threads=4] [repetitions=5] [graph.dagb]
+ */
+
+using BenchGraph = dag::TaskGraph<int>;
+
+// ===== SYNTHETIC GRAPH SHAPES =====
+
+dag::TaskGraph<int>::TaskFn make_work(double cost_ms) {
+    return [cost_ms](const dag::NodeInputs<int>& inputs) {
+        std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long>(cost_ms * 1000)));
+        return static_cast<int>(inputs.size());
+    };
+}
+
+// Random layered DAG: every node depends on 1..max_fan_in nodes of the
+// previous layer; 20% of the nodes are 4-8x more expensive than the rest.
+BenchGraph make_layered_graph(unsigned seed, int layers, int width, int max_fan_in) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> fan_in(1, max_fan_in);
+    std::uniform_int_distribution<int> pick(0, width - 1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    BenchGraph graph;
+    std::vector<dag::NodeId> previous;
+    for (int layer = 0; layer < layers; ++layer) {
+        std::vector<dag::NodeId> current;
+        for (int i = 0; i < width; ++i) {
+            std::vector<dag::NodeId> preds;
+            if (!previous.empty()) {
+                int count = fan_in(rng);
+                for (int k = 0; k < count; ++k) {
+                    preds.push_back(previous[pick(rng)]);
+                }
+                std::sort(preds.begin(), preds.end());
+                preds.erase(std::unique(preds.begin(), preds.end()), preds.end());
+            }
+            double cost = unit(rng) < 0.2 ? 4.0 + 4.0 * unit(rng) : 1.0;
+            current.push_back(graph.add_node("L" + std::to_string(layer) + "_" + std::to_string(i),
+                                             std::move(preds), make_work(cost), cost));
+        }
+        previous = std::move(current);
+    }
+    return graph;
+}
+
+// Many cheap independent leaves added first, plus a few long chains added
+// last: FIFO starts the leaves first and delays the chains.
+BenchGraph make_leaves_and_chains(int leaves, int chains, int chain_length) {
+    BenchGraph graph;
+    for (int i = 0; i < leaves; ++i) {
+        graph.add_node("leaf_" + std::to_string(i), {}, make_work(2.0), 2.0);
+    }
+    for (int c = 0; c < chains; ++c) {
+        dag::NodeId prev = graph.add_node("chain_" + std::to_string(c) + "_0", {}, make_work(3.0), 3.0);
+        for (int k = 1; k < chain_length; ++k) {
+            prev = graph.add_node("chain_" + std::to_string(c) + "_" + std::to_string(k),
+                                  {prev}, make_work(3.0), 3.0);
+        }
+    }
+    return graph;
+}
+
+// Fork-join with uneven branches: one source fans out to `width` branches of
+// random depth, all of which join into a single sink.
+BenchGraph make_uneven_fork_join(unsigned seed, int width, int max_depth) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> depth(1, max_depth);
+
+    BenchGraph graph;
+    dag::NodeId source = graph.add_node("source", {}, make_work(1.0), 1.0);
+    std::vector<dag::NodeId> tails;
+    for (int b = 0; b < width; ++b) {
+        dag::NodeId prev = source;
+        int d = depth(rng);
+        for (int k = 0; k < d; ++k) {
+            prev = graph.add_node("branch_" + std::to_string(b) + "_" + std::to_string(k),
+                                  {prev}, make_work(2.0), 2.0);
+        }
+        tails.push_back(prev);
+    }
+    graph.add_node("sink", std::move(tails), make_work(1.0), 1.0);
+    return graph;
+}
+
+// ===== MEASUREMENT =====
+
+double lower_bound_ms(const BenchGraph& graph, unsigned threads) {
+    double total = 0.0;
+    for (const auto& node : graph.nodes()) {
+        total += node.cost;
+    }
+    auto ranks = graph.upward_ranks();
+    double critical_path = ranks.empty() ? 0.0 : *std::max_element(ranks.begin(), ranks.end());
+    return std::max(critical_path, total / threads);
+}
+
+double median_makespan_ms(const BenchGraph& graph, dag::DispatchPolicy policy,
+                          unifex::static_thread_pool& pool, int repetitions) {
+    dag::GraphExecutor<int> executor(policy);
+    std::vector<double> samples;
+    for (int i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        executor.run(graph, pool.get_scheduler());
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+void run_case(const std::string& name, const BenchGraph& graph,
+              unifex::static_thread_pool& pool, unsigned threads, int repetitions) {
+    double fifo = median_makespan_ms(graph, dag::DispatchPolicy::Fifo, pool, repetitions);
+    double critical = median_makespan_ms(graph, dag::DispatchPolicy::CriticalPath, pool, repetitions);
+    double bound = lower_bound_ms(graph, threads);
+    double reduction = fifo > 0 ? (fifo - critical) / fifo * 100.0 : 0.0;
+
+    std::cout << "  " << std::left << std::setw(28) << name << std::right
+              << std::setw(7) << graph.size()
+              << std::setw(12) << std::fixed << std::setprecision(1) << bound
+              << std::setw(12) << fifo
+              << std::setw(12) << critical
+              << std::setw(11) << reduction << "%" << std::endl;
+}
+
+// ===== RESULT RETENTION: PEAK LIVE BYTES =====
+
+std::atomic<std::size_t> g_live_bytes{0};
+std::atomic<std::size_t> g_peak_live_bytes{0};
+std::atomic<std::size_t> g_blob_allocations{0};
+std::atomic<std::size_t> g_blob_copies{0};
+
+// Large intermediate value whose allocations are tracked
+class Blob {
+private:
+    std::unique_ptr<char[]> bytes_;
+    std::size_t size_ = 0;
+
+    static void track(std::ptrdiff_t delta) {
+        std::size_t live = g_live_bytes.fetch_add(static_cast<std::size_t>(delta)) + static_cast<std::size_t>(delta);
+        std::size_t peak = g_peak_live_bytes.load();
+        while (live > peak && !g_peak_live_bytes.compare_exchange_weak(peak, live)) {
+        }
+    }
+
+public:
+    // An empty Blob owns no buffer and is not counted as an allocation
+    explicit Blob(std::size_t size, char fill) : size_(size) {
+        if (size == 0) {
+            return;
+        }
+        bytes_.reset(new char[size]);
+        std::memset(bytes_.get(), fill, size);
+        track(static_cast<std::ptrdiff_t>(size));
+        g_blob_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    Blob(const Blob& other) : Blob(other.size_, other.first()) {
+        g_blob_copies.fetch_add(1, std::memory_order_relaxed);
+    }
+    Blob(Blob&& other) noexcept : bytes_(std::move(other.bytes_)), size_(other.size_) { other.size_ = 0; }
+    Blob& operator=(const Blob&) = delete;
+    Blob& operator=(Blob&&) = delete;
+    ~Blob() {
+        if (bytes_) {
+            track(-static_cast<std::ptrdiff_t>(size_));
+        }
+    }
+
+    std::size_t size() const { return size_; }
+    char first() const { return bytes_ ? bytes_[0] : 0; }
+    void increment() { if (bytes_) { ++bytes_[0]; } }
+};
+
+// `chains` independent chains of `length` stages; every stage produces a new
+// buffer of `blob_bytes` derived from its input.
+dag::TaskGraph<Blob> make_blob_chains(int chains, int length, std::size_t blob_bytes) {
+    dag::TaskGraph<Blob> graph;
+    for (int c = 0; c < chains; ++c) {
+        dag::NodeId prev = graph.add_node("chain_" + std::to_string(c) + "_0", {},
+            [blob_bytes](const dag::NodeInputs<Blob>&) { return Blob(blob_bytes, 1); });
+        for (int k = 1; k < length; ++k) {
+            prev = graph.add_node("chain_" + std::to_string(c) + "_" + std::to_string(k), {prev},
+                [blob_bytes](const dag::NodeInputs<Blob>& inputs) {
+                    return Blob(blob_bytes, static_cast<char>(inputs[0].first() + 1));
+                });
+        }
+    }
+    return graph;
+}
+
+double peak_live_mb(const dag::TaskGraph<Blob>& graph, dag::ResultRetention retention,
+                    unifex::static_thread_pool& pool) {
+    dag::ExecutorOptions options;
+    options.retention = retention;
+    g_peak_live_bytes.store(0);
+    {
+        dag::GraphExecutor<Blob> executor(options);
+        executor.run(graph, pool.get_scheduler());
+    }
+    return static_cast<double>(g_peak_live_bytes.load()) / (1024.0 * 1024.0);
+}
+
+// ===== EDGE VALUE TRANSFER: COPIES PER RUN =====
+
+// One producer read by `readers` consumers. Borrowing readers use inputs[0]
+// directly; copying readers take their own Blob, as a by-value API would.
+dag::TaskGraph<Blob> make_blob_fan_out(int readers, std::size_t blob_bytes, bool copy_inputs) {
+    dag::TaskGraph<Blob> graph;
+    dag::NodeId source = graph.add_node("source", {},
+        [blob_bytes](const dag::NodeInputs<Blob>&) { return Blob(blob_bytes, 1); });
+    for (int r = 0; r < readers; ++r) {
+        graph.add_node("reader_" + std::to_string(r), {source},
+            [copy_inputs](const dag::NodeInputs<Blob>& inputs) {
+                if (copy_inputs) {
+                    Blob own = inputs[0];
+                    return Blob(0, own.first());
+                }
+                return Blob(0, inputs[0].first());
+            });
+    }
+    return graph;
+}
+
+// Chains whose stages update their input in place and pass it on: every stage
+// take()s its input, so under ReleaseConsumed one buffer travels the chain.
+dag::TaskGraph<Blob> make_in_place_chains(int chains, int length, std::size_t blob_bytes) {
+    dag::TaskGraph<Blob> graph;
+    for (int c = 0; c < chains; ++c) {
+        dag::NodeId prev = graph.add_node("chain_" + std::to_string(c) + "_0", {},
+            [blob_bytes](const dag::NodeInputs<Blob>&) { return Blob(blob_bytes, 1); });
+        for (int k = 1; k < length; ++k) {
+            prev = graph.add_node("chain_" + std::to_string(c) + "_" + std::to_string(k), {prev},
+                [](const dag::NodeInputs<Blob>& inputs) {
+                    Blob blob = inputs.take(0);
+                    blob.increment();
+                    return blob;
+                });
+        }
+    }
+    return graph;
+}
+
+struct TransferCounts {
+    std::size_t allocations;
+    std::size_t copies;
+};
+
+TransferCounts count_transfers(const dag::TaskGraph<Blob>& graph, dag::ResultRetention retention,
+                               unifex::static_thread_pool& pool) {
+    dag::ExecutorOptions options;
+    options.retention = retention;
+    dag::GraphExecutor<Blob> executor(options);
+    g_blob_allocations.store(0);
+    g_blob_copies.store(0);
+    executor.run(graph, pool.get_scheduler());
+    return TransferCounts{g_blob_allocations.load(), g_blob_copies.load()};
+}
+
+void print_transfers(const std::string& name, const TransferCounts& counts) {
+    std::cout << "  " << std::left << std::setw(40) << name << std::right
+              << std::setw(8) << counts.allocations
+              << std::setw(8) << counts.copies << std::endl;
+}
+
+// ===== POOL COMPARISON: FINE-GRAINED FAN-OUT =====
+
+// Busy work instead of sleeping, so the cost is spent on a worker
+BenchGraph::TaskFn make_spin_work(double cost_us) {
+    return [cost_us](const dag::NodeInputs<int>& inputs) {
+        const auto until = std::chrono::steady_clock::now() +
+                           std::chrono::nanoseconds(static_cast<long>(cost_us * 1000));
+        while (std::chrono::steady_clock::now() < until) {
+        }
+        return static_cast<int>(inputs.size());
+    };
+}
+
+// `stages` fork-joins in sequence: one node fans out to `fan_out` leaves,
+// which all feed the next stage's fork node
+BenchGraph make_fan_out_stages(int stages, int fan_out, double cost_us) {
+    BenchGraph graph;
+    dag::NodeId fork = graph.add_node("fork0", {}, make_spin_work(cost_us), cost_us / 1000.0);
+    for (int stage = 0; stage < stages; ++stage) {
+        std::vector<dag::NodeId> leaves;
+        for (int i = 0; i < fan_out; ++i) {
+            leaves.push_back(graph.add_node("leaf" + std::to_string(stage) + "_" + std::to_string(i), {fork},
+                                            make_spin_work(cost_us), cost_us / 1000.0));
+        }
+        fork = graph.add_node("fork" + std::to_string(stage + 1), leaves, make_spin_work(cost_us), cost_us / 1000.0);
+    }
+    return graph;
+}
+
+template<typename Scheduler>
+double median_run_ms(const BenchGraph& graph, Scheduler scheduler, int repetitions) {
+    dag::GraphExecutor<int> executor(dag::DispatchPolicy::Fifo);
+    executor.run(graph, scheduler);  // warm-up: deques and arenas at full size
+    std::vector<double> samples;
+    for (int i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        executor.run(graph, scheduler);
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+void compare_pools(const std::string& name, const BenchGraph& graph, unifex::static_thread_pool& pool,
+                   dag::WorkStealingPool& stealing_pool, dag::WorkStealingPool& pinned_pool, int repetitions) {
+    const dag::WorkStealingStats before = stealing_pool.stats();
+    const double shared_queue = median_run_ms(graph, pool.get_scheduler(), repetitions);
+    const double stealing = median_run_ms(graph, stealing_pool.get_scheduler(), repetitions);
+    const dag::WorkStealingStats after = stealing_pool.stats();
+    const double pinned = median_run_ms(graph, pinned_pool.get_scheduler(), repetitions);
+    const double executed = static_cast<double>(after.executed - before.executed);
+
+    std::cout << "  " << std::left << std::setw(28) << name << std::right
+              << std::setw(7) << graph.size()
+              << std::setw(12) << std::fixed << std::setprecision(2) << shared_queue
+              << std::setw(12) << stealing
+              << std::setw(10) << pinned
+              << std::setw(10) << (stealing > 0 ? shared_queue / stealing : 0.0) << "x"
+              << std::setw(8) << std::setprecision(0)
+              << (executed > 0 ? (after.lifo - before.lifo) / executed * 100.0 : 0.0) << "%"
+              << std::setw(8) << (executed > 0 ? (after.stolen - before.stolen) / executed * 100.0 : 0.0) << "%"
+              << std::endl;
+}
+
+// ===== CHAIN FUSION: SCHEDULER HOPS PER EDGE =====
+
+// `chains` independent chains of `length` microsecond nodes
+BenchGraph make_spin_chains(int chains, int length, double cost_us) {
+    BenchGraph graph;
+    for (int c = 0; c < chains; ++c) {
+        dag::NodeId prev = graph.add_node("chain_" + std::to_string(c) + "_0", {}, make_spin_work(cost_us),
+                                          cost_us / 1000.0);
+        for (int k = 1; k < length; ++k) {
+            prev = graph.add_node("chain_" + std::to_string(c) + "_" + std::to_string(k), {prev},
+                                  make_spin_work(cost_us), cost_us / 1000.0);
+        }
+    }
+    return graph;
+}
+
+void compare_fusion(const std::string& name, const BenchGraph& graph, unifex::static_thread_pool& pool,
+                    int repetitions) {
+    double ms[2];
+    std::size_t fused = 0;
+    for (bool fuse : {false, true}) {
+        dag::ExecutorOptions options;
+        options.policy = dag::DispatchPolicy::Fifo;
+        options.fuse_chains = fuse;
+        dag::GraphExecutor<int> executor(options);
+        executor.run(graph, pool.get_scheduler());
+        std::vector<double> samples;
+        for (int i = 0; i < repetitions; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            executor.run(graph, pool.get_scheduler());
+            auto end = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        std::sort(samples.begin(), samples.end());
+        ms[fuse ? 1 : 0] = samples[samples.size() / 2];
+        fused = executor.last_run_fused();
+    }
+
+    std::cout << "  " << std::left << std::setw(28) << name << std::right
+              << std::setw(7) << graph.size()
+              << std::setw(9) << fused
+              << std::setw(12) << std::fixed << std::setprecision(2) << ms[0]
+              << std::setw(12) << ms[1]
+              << std::setw(10) << (ms[1] > 0 ? ms[0] / ms[1] : 0.0) << "x" << std::endl;
+}
+
+// ===== INLINE FAST PATH: GLUE NODES =====
+
+// `layers` layers of `width` trivial nodes, each combining two nodes of the
+// layer above, so no edge is single-consumer and fusion never applies
+BenchGraph make_glue_layers(int width, int layers, bool annotate) {
+    auto glue = [](const dag::NodeInputs<int>& inputs) {
+        int sum = 0;
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            sum += inputs[i];
+        }
+        return sum % 1000 + 1;
+    };
+    BenchGraph graph;
+    std::vector<dag::NodeId> above;
+    for (int i = 0; i < width; ++i) {
+        above.push_back(graph.add_node("glue_0_" + std::to_string(i), {}, glue, 0.001));
+    }
+    for (int layer = 1; layer < layers; ++layer) {
+        std::vector<dag::NodeId> current;
+        for (int i = 0; i < width; ++i) {
+            current.push_back(graph.add_node("glue_" + std::to_string(layer) + "_" + std::to_string(i),
+                                             {above[i], above[(i + 1) % width]}, glue, 0.001));
+        }
+        above = std::move(current);
+    }
+    if (annotate) {
+        for (dag::NodeId id = 0; id < graph.size(); ++id) {
+            graph.set_inline(id);
+        }
+    }
+    return graph;
+}
+
+double median_inline_run_ms(const BenchGraph& graph, std::chrono::nanoseconds inline_below,
+                            unifex::static_thread_pool& pool, int repetitions, std::size_t& inlined) {
+    dag::ExecutorOptions options;
+    options.inline_below = inline_below;
+    dag::GraphExecutor<int> executor(options);
+    executor.run(graph, pool.get_scheduler());  // warm-up, and the first measurement
+    std::vector<double> samples;
+    for (int i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        executor.run(graph, pool.get_scheduler());
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    inlined = executor.last_run_inlined();
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+void compare_inline(const std::string& name, int width, int layers, unifex::static_thread_pool& pool,
+                    int repetitions) {
+    const BenchGraph plain = make_glue_layers(width, layers, false);
+    const BenchGraph annotated = make_glue_layers(width, layers, true);
+    std::size_t inlined = 0;
+    const double dispatched = median_inline_run_ms(plain, std::chrono::nanoseconds(0), pool, repetitions, inlined);
+    const double marked = median_inline_run_ms(annotated, std::chrono::nanoseconds(0), pool, repetitions, inlined);
+    const double measured = median_inline_run_ms(plain, std::chrono::microseconds(2), pool, repetitions, inlined);
+
+    std::cout << "  " << std::left << std::setw(28) << name << std::right
+              << std::setw(7) << plain.size()
+              << std::setw(12) << std::fixed << std::setprecision(3) << dispatched
+              << std::setw(12) << marked
+              << std::setw(12) << measured
+              << std::setw(9) << inlined
+              << std::setw(10) << std::setprecision(1) << (marked > 0 ? dispatched / marked : 0.0) << "x"
+              << std::endl;
+}
+
+// ===== STREAMING: DAG INSTANCES PER SECOND =====
+
+// Same shape as the task_dag_demo pipeline (3 sources -> 2 transforms -> 1
+// aggregate) at a tenth of its cost; the sources read the instance's input.
+BenchGraph make_request_pipeline(std::function<const int&()> input) {
+    auto source = [input](double cost_ms) -> BenchGraph::TaskFn {
+        return [input, cost_ms](const dag::NodeInputs<int>&) {
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long>(cost_ms * 1000)));
+            return input();
+        };
+    };
+
+    BenchGraph graph;
+    auto a = graph.add_node("source_a", {}, source(10.0), 10.0);
+    auto b = graph.add_node("source_b", {}, source(8.0), 8.0);
+    auto c = graph.add_node("source_c", {}, source(12.0), 12.0);
+    auto d = graph.add_node("transform_d", {a, b}, make_work(6.0), 6.0);
+    auto e = graph.add_node("transform_e", {b, c}, make_work(9.0), 9.0);
+    graph.add_node("aggregate", {d, e}, make_work(5.0), 5.0);
+    return graph;
+}
+
+// Returns the sustained rate; speedup is relative to baseline_rate (0 = this run)
+double run_stream(unsigned in_flight, int instances, unifex::static_thread_pool& pool, double baseline_rate) {
+    dag::StreamOptions options;
+    options.in_flight = in_flight;
+    dag::StreamExecutor<int, int> stream(pool.get_scheduler(), make_request_pipeline, options);
+    for (int i = 0; i < instances; ++i) {
+        stream.submit(i);
+    }
+    stream.wait();
+
+    const dag::StreamStats stats = stream.stats();
+    const double rate = stats.dags_per_second;
+    std::cout << "  " << std::setw(9) << in_flight
+              << std::setw(12) << std::fixed << std::setprecision(1) << rate
+              << std::setw(12) << stream.latency().percentile(0.50) / 1e6
+              << std::setw(12) << stream.latency().percentile(0.99) / 1e6
+              << std::setw(10) << std::setprecision(2) << (baseline_rate > 0 ? rate / baseline_rate : 1.0) << "x"
+              << std::endl;
+    return rate;
+}
+
+// ===== GRAPH FILES: LOAD AND RUN =====
+
+dag::NodeKinds<int> bench_node_kinds() {
+    dag::NodeKinds<int> kinds;
+    kinds["sleep"] = [](const dag::GraphFile::NodeView& node) { return make_work(node.param); };
+    kinds["spin"] = [](const dag::GraphFile::NodeView& node) { return make_spin_work(node.param); };
+    kinds["glue"] = [](const dag::GraphFile::NodeView&) -> BenchGraph::TaskFn {
+        return [](const dag::NodeInputs<int>& inputs) {
+            int sum = 0;
+            for (std::size_t i = 0; i < inputs.size(); ++i) {
+                sum += inputs[i];
+            }
+            return sum;
+        };
+    };
+    return kinds;
+}
+
+void run_graph_file(const std::string& path, unifex::static_thread_pool& pool, unsigned threads, int repetitions) {
+    auto start = std::chrono::steady_clock::now();
+    const dag::GraphFile file(path);
+    auto mapped = std::chrono::steady_clock::now();
+    const BenchGraph graph = dag::load_task_graph<int>(file, bench_node_kinds());
+    auto built = std::chrono::steady_clock::now();
+
+    std::cout << "  " << file.size() << " nodes, " << file.edge_count() << " edges; mapped in " << std::fixed
+              << std::setprecision(2) << std::chrono::duration<double, std::milli>(mapped - start).count()
+              << " ms, TaskGraph built in " << std::chrono::duration<double, std::milli>(built - mapped).count()
+              << " ms" << std::endl;
+    std::cout << "  " << std::left << std::setw(28) << "graph" << std::right << std::setw(7) << "nodes"
+              << std::setw(12) << "bound" << std::setw(12) << "fifo" << std::setw(12) << "critical"
+              << std::setw(12) << "reduction" << std::endl;
+    const std::size_t slash = path.find_last_of('/');
+    run_case(slash == std::string::npos ? path : path.substr(slash + 1), graph, pool, threads, repetitions);
+}
+
+// ===== MAIN FUNCTION =====
+
+int main(int argc, char** argv) {
+    unsigned threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 4;
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 5;
+    if (threads == 0 || repetitions <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [threads] [repetitions] [graph.dagb]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "=== DAG SCHEDULING BENCHMARK: FIFO vs CRITICAL-PATH PRIORITY ===" << std::endl;
+    std::cout << "Pool threads: " << threads << ", repetitions: " << repetitions
+              << " (median makespan reported, times in ms)\n" << std::endl;
+
+    unifex::static_thread_pool pool{threads};
+
+    std::cout << "  " << std::left << std::setw(28) << "graph" << std::right
+              << std::setw(7) << "nodes"
+              << std::setw(12) << "bound"
+              << std::setw(12) << "fifo"
+              << std::setw(12) << "critical"
+              << std::setw(12) << "reduction" << std::endl;
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+
+    run_case("leaves(48)+chains(3x12)", make_leaves_and_chains(48, 3, 12), pool, threads, repetitions);
+    run_case("layered 6x24, fan-in<=3", make_layered_graph(7, 6, 24, 3), pool, threads, repetitions);
+    run_case("layered 10x32, fan-in<=2", make_layered_graph(11, 10, 32, 2), pool, threads, repetitions);
+    run_case("uneven fork-join 32x<=10", make_uneven_fork_join(3, 32, 10), pool, threads, repetitions);
+
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+    std::cout << "💡 bound = max(critical path, total work / threads); no schedule can beat it." << std::endl;
+
+    std::cout << "\n=== RESULT RETENTION: PEAK LIVE RESULT MEMORY ===" << std::endl;
+    const int chains = 4;
+    const int length = 16;
+    const std::size_t blob_bytes = 1024 * 1024;
+    auto blob_graph = make_blob_chains(chains, length, blob_bytes);
+    std::cout << "  " << chains << " chains x " << length << " stages, "
+              << blob_bytes / (1024 * 1024) << " MB per intermediate" << std::endl;
+    std::cout << "  KeepAll:         " << std::setprecision(1)
+              << peak_live_mb(blob_graph, dag::ResultRetention::KeepAll, pool) << " MB peak" << std::endl;
+    std::cout << "  ReleaseConsumed: "
+              << peak_live_mb(blob_graph, dag::ResultRetention::ReleaseConsumed, pool) << " MB peak" << std::endl;
+
+    std::cout << "\n=== EDGE VALUE TRANSFER: BLOB ALLOCATIONS PER RUN ===" << std::endl;
+    std::cout << "  " << std::left << std::setw(40) << "graph" << std::right
+              << std::setw(8) << "allocs" << std::setw(8) << "copies" << std::endl;
+    const int readers = 8;
+    print_transfers("fan-out 1->8, readers copy input",
+                    count_transfers(make_blob_fan_out(readers, blob_bytes, true),
+                                    dag::ResultRetention::KeepAll, pool));
+    print_transfers("fan-out 1->8, readers borrow input",
+                    count_transfers(make_blob_fan_out(readers, blob_bytes, false),
+                                    dag::ResultRetention::KeepAll, pool));
+    auto in_place = make_in_place_chains(chains, length, blob_bytes);
+    print_transfers("in-place chains, take() + KeepAll",
+                    count_transfers(in_place, dag::ResultRetention::KeepAll, pool));
+    print_transfers("in-place chains, take() + ReleaseConsumed",
+                    count_transfers(in_place, dag::ResultRetention::ReleaseConsumed, pool));
+    std::cout << "💡 take() moves when the caller is the last consumer under ReleaseConsumed;" << std::endl;
+    std::cout << "   with KeepAll the producer's value must survive the run, so it copies." << std::endl;
+
+    std::cout << "\n=== POOLS: static_thread_pool vs WorkStealingPool (fifo dispatch, ms) ===" << std::endl;
+    {
+        dag::WorkStealingPool stealing_pool{threads};
+        dag::WorkerPlacement placement;
+        placement.pin = true;
+        dag::WorkStealingPool pinned_pool{threads, placement};
+        const dag::CpuTopology topology = dag::CpuTopology::detect();
+        std::cout << "  🧭 " << topology.cpus().size() << " usable CPU(s) on " << topology.node_count()
+                  << " NUMA node(s); pinned workers on CPUs";
+        for (int cpu : pinned_pool.worker_cpus()) {
+            std::cout << " " << cpu;
+        }
+        std::cout << std::endl;
+        std::cout << "  " << std::left << std::setw(28) << "graph" << std::right
+                  << std::setw(7) << "nodes" << std::setw(12) << "static" << std::setw(12) << "stealing"
+                  << std::setw(10) << "pinned" << std::setw(11) << "speedup" << std::setw(9) << "lifo"
+                  << std::setw(9) << "stolen" << std::endl;
+        compare_pools("fan-out 8x(1->256), 2us", make_fan_out_stages(8, 256, 2.0), pool, stealing_pool, pinned_pool, repetitions);
+        compare_pools("fan-out 4x(1->1024), 1us", make_fan_out_stages(4, 1024, 1.0), pool, stealing_pool, pinned_pool, repetitions);
+        compare_pools("fan-out 16x(1->64), 20us", make_fan_out_stages(16, 64, 20.0), pool, stealing_pool, pinned_pool, repetitions);
+    }
+    std::cout << "💡 lifo = tasks run from the scheduling worker's own LIFO slot, stolen = taken" << std::endl;
+    std::cout << "   from another worker's deque; both bypass the shared queue." << std::endl;
+    std::cout << "   pinned = the same pool with each worker bound to a CPU; pinned workers steal" << std::endl;
+    std::cout << "   from their own NUMA node first." << std::endl;
+
+    std::cout << "\n=== CHAIN FUSION: QUEUE HOP vs INLINE CONTINUATION (fifo dispatch, ms) ===" << std::endl;
+    std::cout << "  " << std::left << std::setw(28) << "graph" << std::right << std::setw(7) << "nodes"
+              << std::setw(9) << "inlined" << std::setw(12) << "hop" << std::setw(12) << "fused" << std::setw(11)
+              << "speedup" << std::endl;
+    compare_fusion("chains 4x1024, 1us", make_spin_chains(4, 1024, 1.0), pool, repetitions);
+    compare_fusion("chains 64x64, 1us", make_spin_chains(64, 64, 1.0), pool, repetitions);
+    compare_fusion("fan-out 8x(1->256), 2us", make_fan_out_stages(8, 256, 2.0), pool, repetitions);
+    std::cout << "💡 a node whose only producer just finished runs in that producer's job;" << std::endl;
+    std::cout << "   fan-out edges still go through the scheduler so the leaves spread out." << std::endl;
+
+    std::cout << "\n=== INLINE FAST PATH: GLUE-DOMINATED GRAPHS (critical-path dispatch, ms) ===" << std::endl;
+    std::cout << "  " << std::left << std::setw(28) << "graph" << std::right << std::setw(7) << "nodes"
+              << std::setw(12) << "dispatched" << std::setw(12) << "set_inline" << std::setw(12) << "measured"
+              << std::setw(9) << "inlined" << std::setw(11) << "speedup" << std::endl;
+    compare_inline("glue 16 wide x 8 deep", 16, 8, pool, repetitions);
+    compare_inline("glue 64 wide x 32 deep", 64, 32, pool, repetitions);
+    std::cout << "💡 set_inline = every node marked inline; measured = inline_below 2us, nodes" << std::endl;
+    std::cout << "   classified from their run times after the first run." << std::endl;
+
+    std::cout << "\n=== STREAMING: DAG INSTANCES PER SECOND ===" << std::endl;
+    const int instances = 12 * repetitions;
+    std::cout << "  " << instances << " instances of a 6-node pipeline (critical path 26 ms, 50 ms of work)" << std::endl;
+    std::cout << "  " << std::setw(9) << "in flight" << std::setw(12) << "DAGs/sec"
+              << std::setw(12) << "p50 ms" << std::setw(12) << "p99 ms" << std::setw(11) << "speedup" << std::endl;
+    double baseline_rate = 0.0;
+    for (unsigned in_flight : {1u, 2u, 4u, 8u}) {
+        const double rate = run_stream(in_flight, instances, pool, baseline_rate);
+        if (baseline_rate == 0.0) {
+            baseline_rate = rate;
+        }
+    }
+    std::cout << "💡 one instance leaves workers idle while its narrow tail runs; with several in" << std::endl;
+    std::cout << "   flight the next instance's sources fill them, up to total work / threads." << std::endl;
+
+    if (argc > 3) {
+        std::cout << "\n=== GRAPH FILE: " << argv[3] << " ===" << std::endl;
+        try {
+            run_graph_file(argv[3], pool, threads, repetitions);
+        } catch (const std::exception& e) {
+            std::cerr << "❌ " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
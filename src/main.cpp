@@ -5,6 +5,9 @@
 #include <vector>
 #include <string>
 #include <iomanip>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 #include <unifex/static_thread_pool.hpp>
 #include <unifex/sync_wait.hpp>
 #include <unifex/scheduler_concepts.hpp>
@@ -13,43 +16,89 @@
 #include <unifex/then.hpp>
 #include <unifex/let_value.hpp>
 #include <unifex/when_all.hpp>
+#include <unifex/execute.hpp>
+#include <unifex/submit.hpp>
+#include <dag/async_delay.hpp>
+#include <dag/async_log.hpp>
+#include <dag/work_stealing_pool.hpp>
 // Note: UNIFEX_NO_COROUTINES=1 disables coroutine support for C++17 compatibility
 
 namespace fs = std::filesystem;
 
-// Helper function to simulate data processing
-std::vector<int> simulate_data_fetch(int size) {
-    std::vector<int> data;
-    for (int i = 1; i <= size; ++i) {
-        data.push_back(i * 10);
-    }
-    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // Simulate network/disk I/O
-    return data;
+// Helper function to simulate data processing. The waits below are
+// dag::delay() senders: they complete from a timer thread instead of
+// sleeping on (and occupying) a pool worker. Code running on the pool or
+// timer thread prints with dag::log_line(), which never blocks on the
+// terminal; main() calls dag::flush_log() after each sync_wait before it
+// prints again.
+auto simulate_data_fetch(int size) {
+    return dag::delay(std::chrono::milliseconds(50)) // Simulate network/disk I/O
+        | unifex::then([size]() {
+            std::vector<int> data;
+            for (int i = 1; i <= size; ++i) {
+                data.push_back(i * 10);
+            }
+            return data;
+        });
 }
 
 // Processor 1: Square all values
-std::vector<int> square_processor(const std::vector<int>& data) {
-    std::cout << "  [Processor 1] Squaring values on thread: " << std::this_thread::get_id() << std::endl;
-    std::vector<int> result;
-    for (int val : data) {
-        result.push_back(val * val);
-        std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Simulate processing time
-    }
-    return result;
+auto square_processor(const std::vector<int>& data) {
+    dag::log_line("  [Processor 1] Squaring values on thread: ", std::this_thread::get_id());
+    return dag::delay(std::chrono::milliseconds(10) * data.size()) // Simulate processing time
+        | unifex::then([data]() {
+            std::vector<int> result;
+            for (int val : data) {
+                result.push_back(val * val);
+            }
+            return result;
+        });
 }
 
 // Processor 2: Sum and analyze
-std::string analyze_processor(const std::vector<int>& data) {
-    std::cout << "  [Processor 2] Analyzing data on thread: " << std::this_thread::get_id() << std::endl;
-    std::this_thread::sleep_for(std::chrono::milliseconds(30)); // Simulate analysis time
+auto analyze_processor(const std::vector<int>& data) {
+    dag::log_line("  [Processor 2] Analyzing data on thread: ", std::this_thread::get_id());
+    return dag::delay(std::chrono::milliseconds(30)) // Simulate analysis time
+        | unifex::then([data]() {
+            int sum = 0;
+            for (int val : data) {
+                sum += val;
+            }
 
-    int sum = 0;
-    for (int val : data) {
-        sum += val;
+            return "Analysis: " + std::to_string(data.size()) + " items, sum=" + std::to_string(sum);
+        });
+}
+
+// Counts finished waits down and wakes whoever waits for the last one
+class WaitLatch {
+public:
+    explicit WaitLatch(int count) : remaining_(count) {}
+
+    void count_down() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--remaining_ == 0) {
+            done_.notify_all();
+        }
     }
 
-    return "Analysis: " + std::to_string(data.size()) + " items, sum=" + std::to_string(sum);
-}
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return remaining_ == 0; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable done_;
+    int remaining_;
+};
+
+struct LatchReceiver {
+    WaitLatch* latch;
+
+    void set_value() && noexcept { latch->count_down(); }
+    void set_error(std::exception_ptr) && noexcept { latch->count_down(); }
+    void set_done() && noexcept { latch->count_down(); }
+};
 
 int main() {
     std::cout << "C++17 Application with libunifex" << std::endl;
@@ -87,13 +136,16 @@ int main() {
         auto pool_scheduler = pool.get_scheduler();
 
         auto thread_work = unifex::schedule(pool_scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("Work executed on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(100));
+            })
             | unifex::then([]() {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                std::cout << "Work executed on thread: " << std::this_thread::get_id() << std::endl;
                 return 42;
             });
 
         auto thread_result = unifex::sync_wait(std::move(thread_work));
+        dag::flush_log();
         if (thread_result.has_value()) {
             std::cout << "Thread pool result: " << *thread_result << std::endl;
         }
@@ -105,7 +157,7 @@ int main() {
     std::cout << std::string(50, '=') << std::endl;
 
     {
-        unifex::static_thread_pool pool{3}; // 3 worker threads for better parallelism
+        dag::WorkStealingPool pool{3}; // 3 workers, each with its own deque; same scheduler concept
         auto scheduler = pool.get_scheduler();
 
         std::cout << "\nStep 1: Data Producer (JOIN point)" << std::endl;
@@ -113,13 +165,14 @@ int main() {
 
         // PRODUCER TASK: Fetch/generate data (this is our JOIN point)
         auto producer = unifex::schedule(scheduler)
-            | unifex::then([]() {
-                std::cout << "  [Producer] Fetching data on thread: " << std::this_thread::get_id() << std::endl;
+            | unifex::let_value([]() {
+                dag::log_line("  [Producer] Fetching data on thread: ", std::this_thread::get_id());
                 return simulate_data_fetch(5); // Generate vector of 5 elements
             });
 
         // Execute the producer first to get the data
         auto data_result = unifex::sync_wait(std::move(producer));
+        dag::flush_log();
 
         if (data_result.has_value()) {
             auto data = *data_result;
@@ -135,13 +188,13 @@ int main() {
             // FORK: Create two parallel tasks that process the same input data
             std::cout << "  Launching Task 1 (Square Processor)..." << std::endl;
             auto task1 = unifex::schedule(scheduler)
-                | unifex::then([data]() {
+                | unifex::let_value([data]() {
                     return square_processor(data);
                 });
 
             std::cout << "  Launching Task 2 (Analysis Processor)..." << std::endl;
             auto task2 = unifex::schedule(scheduler)
-                | unifex::then([data]() {
+                | unifex::let_value([data]() {
                     return analyze_processor(data);
                 });
 
@@ -154,6 +207,7 @@ int main() {
             auto result2 = unifex::sync_wait(std::move(task2));
 
             auto end_time = std::chrono::steady_clock::now();
+            dag::flush_log();
             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
             if (result1.has_value() && result2.has_value()) {
@@ -197,7 +251,7 @@ int main() {
     std::cout << std::string(60, '=') << std::endl;
 
     {
-        unifex::static_thread_pool pool{4}; // 4 worker threads for complex workflow
+        dag::WorkStealingPool pool{4}; // 4 work-stealing workers for complex workflow
         auto scheduler = pool.get_scheduler();
 
         std::cout << "\nStep 1: INITIAL FORK - Parallel Data Sources" << std::endl;
@@ -205,25 +259,31 @@ int main() {
 
         // INITIAL FORK: Multiple parallel data sources
         auto source1 = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Source 1] Fetching user data on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(60));
+            })
             | unifex::then([]() {
-                std::cout << "  [Source 1] Fetching user data on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(60));
                 std::vector<int> user_data = {1, 2, 3, 4, 5};
                 return user_data;
             });
 
         auto source2 = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Source 2] Fetching config data on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(40));
+            })
             | unifex::then([]() {
-                std::cout << "  [Source 2] Fetching config data on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(40));
                 std::vector<int> config_data = {10, 20, 30};
                 return config_data;
             });
 
         auto source3 = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Source 3] Fetching metrics data on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(80));
+            })
             | unifex::then([]() {
-                std::cout << "  [Source 3] Fetching metrics data on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(80));
                 std::vector<int> metrics_data = {100, 200};
                 return metrics_data;
             });
@@ -237,6 +297,7 @@ int main() {
         auto result3 = unifex::sync_wait(std::move(source3));
 
         auto fork1_time = std::chrono::steady_clock::now();
+        dag::flush_log();
         auto fork1_duration = std::chrono::duration_cast<std::chrono::milliseconds>(fork1_time - start_time);
 
         if (result1.has_value() && result2.has_value() && result3.has_value()) {
@@ -245,22 +306,24 @@ int main() {
             // JOIN: Merge all data sources
             std::cout << "\nStep 2: JOIN - Merging Data Sources" << std::endl;
             auto join_processor = unifex::schedule(scheduler)
+                | unifex::let_value([]() {
+                    dag::log_line("  [Joiner] Merging data on thread: ", std::this_thread::get_id());
+                    return dag::delay(std::chrono::milliseconds(30));
+                })
                 | unifex::then([user_data = *result1, config_data = *result2, metrics_data = *result3]() {
-                    std::cout << "  [Joiner] Merging data on thread: " << std::this_thread::get_id() << std::endl;
-                    std::this_thread::sleep_for(std::chrono::milliseconds(30));
-
                     // Combine all data into a unified dataset
                     std::vector<int> merged_data;
                     merged_data.insert(merged_data.end(), user_data.begin(), user_data.end());
                     merged_data.insert(merged_data.end(), config_data.begin(), config_data.end());
                     merged_data.insert(merged_data.end(), metrics_data.begin(), metrics_data.end());
 
-                    std::cout << "  ✓ Merged " << merged_data.size() << " total elements" << std::endl;
+                    dag::log_line("  ✓ Merged ", merged_data.size(), " total elements");
                     return merged_data;
                 });
 
             auto join_result = unifex::sync_wait(std::move(join_processor));
             auto join_time = std::chrono::steady_clock::now();
+            dag::flush_log();
             auto join_duration = std::chrono::duration_cast<std::chrono::milliseconds>(join_time - fork1_time);
 
             if (join_result.has_value()) {
@@ -270,10 +333,11 @@ int main() {
                 // MIDDLE PRODUCER: Process merged data and decide next actions
                 std::cout << "\nStep 3: MIDDLE PRODUCER - Data Analysis & Decision" << std::endl;
                 auto analyzer = unifex::schedule(scheduler)
+                    | unifex::let_value([]() {
+                        dag::log_line("  [Analyzer] Processing merged data on thread: ", std::this_thread::get_id());
+                        return dag::delay(std::chrono::milliseconds(50));
+                    })
                     | unifex::then([merged_data]() {
-                        std::cout << "  [Analyzer] Processing merged data on thread: " << std::this_thread::get_id() << std::endl;
-                        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-
                         // Calculate statistics
                         int sum = 0;
                         int max_val = 0;
@@ -298,15 +362,16 @@ int main() {
                         result.needs_alert = (max_val > 150);  // Alert if max > 150
                         result.needs_report = (sum > 300);     // Report if sum > 300
 
-                        std::cout << "  ✓ Analysis: sum=" << sum << ", max=" << max_val
-                                 << ", alert=" << (result.needs_alert ? "YES" : "NO")
-                                 << ", report=" << (result.needs_report ? "YES" : "NO") << std::endl;
+                        dag::log_line("  ✓ Analysis: sum=", sum, ", max=", max_val, ", alert=",
+                                      (result.needs_alert ? "YES" : "NO"), ", report=",
+                                      (result.needs_report ? "YES" : "NO"));
 
                         return result;
                     });
 
                 auto analysis_result = unifex::sync_wait(std::move(analyzer));
                 auto analysis_time = std::chrono::steady_clock::now();
+                dag::flush_log();
                 auto analysis_duration = std::chrono::duration_cast<std::chrono::milliseconds>(analysis_time - join_time);
 
                 if (analysis_result.has_value()) {
@@ -317,17 +382,21 @@ int main() {
                     std::cout << "\nStep 4: SECONDARY FORK - Parallel Action Execution" << std::endl;
 
                     auto storage_task = unifex::schedule(scheduler)
+                        | unifex::let_value([]() {
+                            dag::log_line("  [Storage] Saving data on thread: ", std::this_thread::get_id());
+                            return dag::delay(std::chrono::milliseconds(70));
+                        })
                         | unifex::then([analysis]() {
-                            std::cout << "  [Storage] Saving data on thread: " << std::this_thread::get_id() << std::endl;
-                            std::this_thread::sleep_for(std::chrono::milliseconds(70));
                             return "Data saved to storage with " + std::to_string(analysis.data.size()) + " records";
                         });
 
                     // Conditional tasks based on analysis
                     auto alert_task = unifex::schedule(scheduler)
+                        | unifex::let_value([]() {
+                            dag::log_line("  [Alert] Processing alerts on thread: ", std::this_thread::get_id());
+                            return dag::delay(std::chrono::milliseconds(45));
+                        })
                         | unifex::then([analysis]() -> std::string {
-                            std::cout << "  [Alert] Processing alerts on thread: " << std::this_thread::get_id() << std::endl;
-                            std::this_thread::sleep_for(std::chrono::milliseconds(45));
                             if (analysis.needs_alert) {
                                 return "⚠️  ALERT: High value detected (max=" + std::to_string(analysis.max_val) + ")";
                             } else {
@@ -336,9 +405,11 @@ int main() {
                         });
 
                     auto report_task = unifex::schedule(scheduler)
+                        | unifex::let_value([]() {
+                            dag::log_line("  [Report] Generating report on thread: ", std::this_thread::get_id());
+                            return dag::delay(std::chrono::milliseconds(90));
+                        })
                         | unifex::then([analysis]() -> std::string {
-                            std::cout << "  [Report] Generating report on thread: " << std::this_thread::get_id() << std::endl;
-                            std::this_thread::sleep_for(std::chrono::milliseconds(90));
                             if (analysis.needs_report) {
                                 return "📊 Report generated: Total sum=" + std::to_string(analysis.sum) + " (threshold exceeded)";
                             } else {
@@ -353,6 +424,7 @@ int main() {
                     auto report_result = unifex::sync_wait(std::move(report_task));
 
                     auto end_time = std::chrono::steady_clock::now();
+                    dag::flush_log();
                     auto final_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - analysis_time);
                     auto total_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
@@ -407,23 +479,29 @@ int main() {
         auto seq_start = std::chrono::steady_clock::now();
 
         auto task_a = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Sequential] Task A on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(100));
+            })
             | unifex::then([]() {
-                std::cout << "  [Sequential] Task A on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
                 return 42;
             });
 
         auto task_b = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Sequential] Task B on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(80));
+            })
             | unifex::then([]() {
-                std::cout << "  [Sequential] Task B on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(80));
                 return 99;
             });
 
         auto task_c = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Sequential] Task C on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(60));
+            })
             | unifex::then([]() {
-                std::cout << "  [Sequential] Task C on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(60));
                 return 77;
             });
 
@@ -433,6 +511,7 @@ int main() {
         auto result_c = unifex::sync_wait(std::move(task_c));
 
         auto seq_end = std::chrono::steady_clock::now();
+        dag::flush_log();
         auto seq_duration = std::chrono::duration_cast<std::chrono::milliseconds>(seq_end - seq_start);
 
         std::cout << "  ✓ Sequential results: ";
@@ -447,23 +526,29 @@ int main() {
         auto parallel_start = std::chrono::steady_clock::now();
 
         auto parallel_task_a = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Parallel] Task A on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(100));
+            })
             | unifex::then([]() {
-                std::cout << "  [Parallel] Task A on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
                 return 42;
             });
 
         auto parallel_task_b = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Parallel] Task B on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(80));
+            })
             | unifex::then([]() {
-                std::cout << "  [Parallel] Task B on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(80));
                 return 99;
             });
 
         auto parallel_task_c = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Parallel] Task C on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(60));
+            })
             | unifex::then([]() {
-                std::cout << "  [Parallel] Task C on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(60));
                 return 77;
             });
 
@@ -478,6 +563,7 @@ int main() {
         auto parallel_results = unifex::sync_wait(std::move(when_all_sender));
 
         auto parallel_end = std::chrono::steady_clock::now();
+        dag::flush_log();
         auto parallel_duration = std::chrono::duration_cast<std::chrono::milliseconds>(parallel_end - parallel_start);
 
         if (parallel_results.has_value()) {
@@ -502,19 +588,19 @@ int main() {
         std::cout << "\n4. SIMPLE WHEN_ALL USAGE:" << std::endl;
 
         // Simple uniform type tasks for easier handling
-        auto simple_task1 = unifex::just(10) | unifex::then([](int x) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            return x * 2; // 20
+        auto simple_task1 = unifex::just(10) | unifex::let_value([](int x) {
+            return dag::delay(std::chrono::milliseconds(50))
+                | unifex::then([x]() { return x * 2; }); // 20
         });
 
-        auto simple_task2 = unifex::just(5) | unifex::then([](int x) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(30));
-            return x * 3; // 15
+        auto simple_task2 = unifex::just(5) | unifex::let_value([](int x) {
+            return dag::delay(std::chrono::milliseconds(30))
+                | unifex::then([x]() { return x * 3; }); // 15
         });
 
-        auto simple_task3 = unifex::just(7) | unifex::then([](int x) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(40));
-            return x * 4; // 28
+        auto simple_task3 = unifex::just(7) | unifex::let_value([](int x) {
+            return dag::delay(std::chrono::milliseconds(40))
+                | unifex::then([x]() { return x * 4; }); // 28
         });
 
         std::cout << "  Executing simple when_all with uniform int results..." << std::endl;
@@ -561,25 +647,31 @@ int main() {
 
         // Task returning int
         auto int_task = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Int Task] Computing on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(70));
+            })
             | unifex::then([]() {
-                std::cout << "  [Int Task] Computing on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(70));
                 return 42;
             });
 
         // Task returning string
         auto string_task = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [String Task] Processing on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(50));
+            })
             | unifex::then([]() {
-                std::cout << "  [String Task] Processing on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
                 return std::string("Hello World");
             });
 
         // Task returning double
         auto double_task = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Double Task] Calculating on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(60));
+            })
             | unifex::then([]() {
-                std::cout << "  [Double Task] Calculating on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(60));
                 return 3.14159;
             });
 
@@ -591,9 +683,11 @@ int main() {
         };
 
         auto struct_task = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Struct Task] Building result on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(40));
+            })
             | unifex::then([]() {
-                std::cout << "  [Struct Task] Building result on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(40));
                 return TaskResult{200, "OK", true};
             });
 
@@ -611,6 +705,7 @@ int main() {
         );
 
         auto mixed_end = std::chrono::steady_clock::now();
+        dag::flush_log();
         auto mixed_duration = std::chrono::duration_cast<std::chrono::milliseconds>(mixed_end - mixed_start);
 
         if (mixed_results.has_value()) {
@@ -626,23 +721,29 @@ int main() {
         std::cout << "\nApproach 1: Convert all tasks to common return type" << std::endl;
 
         auto unified_int_task = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Unified Int] on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(30));
+            })
             | unifex::then([]() {
-                std::cout << "  [Unified Int] on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(30));
                 return std::string("Result: 42");
             });
 
         auto unified_string_task = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Unified String] on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(25));
+            })
             | unifex::then([]() {
-                std::cout << "  [Unified String] on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(25));
                 return std::string("Result: Hello World");
             });
 
         auto unified_double_task = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Unified Double] on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(35));
+            })
             | unifex::then([]() {
-                std::cout << "  [Unified Double] on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(35));
                 return std::string("Result: 3.14159");
             });
 
@@ -655,6 +756,7 @@ int main() {
             )
         );
         auto unified_end = std::chrono::steady_clock::now();
+        dag::flush_log();
         auto unified_duration = std::chrono::duration_cast<std::chrono::milliseconds>(unified_end - unified_start);
 
         if (unified_results.has_value()) {
@@ -668,23 +770,29 @@ int main() {
         using CommonType = std::variant<int, std::string, double>;
 
         auto variant_int_task = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Variant Int] on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(30));
+            })
             | unifex::then([]() -> CommonType {
-                std::cout << "  [Variant Int] on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(30));
                 return 42;
             });
 
         auto variant_string_task = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Variant String] on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(25));
+            })
             | unifex::then([]() -> CommonType {
-                std::cout << "  [Variant String] on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(25));
                 return std::string("Hello Variant");
             });
 
         auto variant_double_task = unifex::schedule(scheduler)
+            | unifex::let_value([]() {
+                dag::log_line("  [Variant Double] on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(35));
+            })
             | unifex::then([]() -> CommonType {
-                std::cout << "  [Variant Double] on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(35));
                 return 2.71828;
             });
 
@@ -697,6 +805,7 @@ int main() {
             )
         );
         auto variant_end = std::chrono::steady_clock::now();
+        dag::flush_log();
         auto variant_duration = std::chrono::duration_cast<std::chrono::milliseconds>(variant_end - variant_start);
 
         if (variant_results.has_value()) {
@@ -710,30 +819,37 @@ int main() {
         auto seq_start = std::chrono::steady_clock::now();
 
         auto seq_int = unifex::sync_wait(
-            unifex::schedule(scheduler) | unifex::then([]() {
-                std::cout << "  [Sequential] Int task on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            unifex::schedule(scheduler) | unifex::let_value([]() {
+                dag::log_line("  [Sequential] Int task on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(30));
+            })
+            | unifex::then([]() {
                 return 99;
             })
         );
 
         auto seq_string = unifex::sync_wait(
-            unifex::schedule(scheduler) | unifex::then([]() {
-                std::cout << "  [Sequential] String task on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(25));
+            unifex::schedule(scheduler) | unifex::let_value([]() {
+                dag::log_line("  [Sequential] String task on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(25));
+            })
+            | unifex::then([]() {
                 return std::string("Sequential Result");
             })
         );
 
         auto seq_double = unifex::sync_wait(
-            unifex::schedule(scheduler) | unifex::then([]() {
-                std::cout << "  [Sequential] Double task on thread: " << std::this_thread::get_id() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(35));
+            unifex::schedule(scheduler) | unifex::let_value([]() {
+                dag::log_line("  [Sequential] Double task on thread: ", std::this_thread::get_id());
+                return dag::delay(std::chrono::milliseconds(35));
+            })
+            | unifex::then([]() {
                 return 1.41421;
             })
         );
 
         auto seq_end = std::chrono::steady_clock::now();
+        dag::flush_log();
         auto seq_duration = std::chrono::duration_cast<std::chrono::milliseconds>(seq_end - seq_start);
 
         if (seq_int.has_value() && seq_string.has_value() && seq_double.has_value()) {
@@ -760,6 +876,57 @@ int main() {
     std::cout << "🎯 RECOMMENDATION: Use std::variant or convert to common types for when_all" << std::endl;
     std::cout << std::string(60, '=') << std::endl;
 
+    // === ASYNC DELAY VS BLOCKING SLEEP ===
+    std::cout << "\n" << std::string(60, '=') << std::endl;
+    std::cout << "ASYNC DELAY VS BLOCKING SLEEP" << std::endl;
+    std::cout << std::string(60, '=') << std::endl;
+
+    {
+        unifex::static_thread_pool pool{4}; // 4 worker threads
+        auto scheduler = pool.get_scheduler();
+
+        constexpr int kWaits = 200;
+        const auto wait = std::chrono::milliseconds(50);
+        std::cout << "\n" << kWaits << " simulated I/O waits of " << wait.count()
+                  << "ms each on a 4-thread pool" << std::endl;
+
+        // Blocking: every wait occupies a worker, so only 4 overlap at a time
+        auto blocking_start = std::chrono::steady_clock::now();
+        WaitLatch blocking_waits(kWaits);
+        for (int i = 0; i < kWaits; ++i) {
+            unifex::execute(scheduler, [&blocking_waits, wait]() {
+                std::this_thread::sleep_for(wait);
+                blocking_waits.count_down();
+            });
+        }
+        blocking_waits.wait();
+        auto blocking_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - blocking_start);
+
+        // Async: a worker only arms a timer and moves on, so all waits overlap
+        auto async_start = std::chrono::steady_clock::now();
+        WaitLatch async_waits(kWaits);
+        for (int i = 0; i < kWaits; ++i) {
+            unifex::submit(
+                unifex::schedule(scheduler) | unifex::let_value([wait]() { return dag::delay(wait); }),
+                LatchReceiver{&async_waits});
+        }
+        async_waits.wait();
+        auto async_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - async_start);
+
+        const auto waits_per_second = [](std::chrono::milliseconds duration) {
+            return kWaits * 1000.0 / std::max<std::chrono::milliseconds::rep>(duration.count(), 1);
+        };
+        std::cout << "  std::this_thread::sleep_for: " << blocking_duration.count() << "ms ("
+                  << std::fixed << std::setprecision(0) << waits_per_second(blocking_duration) << " waits/s)" << std::endl;
+        std::cout << "  dag::delay sender:           " << async_duration.count() << "ms ("
+                  << waits_per_second(async_duration) << " waits/s)" << std::endl;
+        std::cout << "  🚀 " << std::setprecision(1)
+                  << static_cast<double>(blocking_duration.count()) / std::max<std::chrono::milliseconds::rep>(async_duration.count(), 1)
+                  << "x more waits in flight without adding threads" << std::endl;
+    }
+
     std::cout << "\nApplication completed successfully!" << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -10,12 +10,28 @@
 #include <variant>
 #include <any>
 #include <typeinfo>
-#include <unifex/static_thread_pool.hpp>
+#include <typeindex>
+#include <vector>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <unifex/sync_wait.hpp>
-#include <unifex/just.hpp>
-#include <unifex/then.hpp>
-#include <unifex/when_all.hpp>
 #include <unifex/scheduler_concepts.hpp>
+#include <unifex/then.hpp>
+#include <unifex/any_sender_of.hpp>
+#include <dag/async_delay.hpp>
+#include <dag/async_log.hpp>
+#include <dag/dag_executor.hpp>
+#include <dag/graph_file.hpp>
+#include <dag/latency_histogram.hpp>
+#include <dag/result_cache.hpp>
+#include <dag/trace_recorder.hpp>
+#include <dag/work_stealing_pool.hpp>
+#include <dag/typed_dag.hpp>
 
 /*
  * TASK DEPENDENCY GRAPH (DAG) - FLEXIBLE TYPE-SAFE OOP VERSION:
@@ -28,22 +44,83 @@
  *              ┌───►        ▲
  *     Task3 ────┘            │
  *
+ * Execution is dependency-driven: each task is dispatched to the pool as soon
+ * as the tasks it depends on have finished (Task4 does not wait for Task3).
+ * Tasks report progress through dag::log_line(), so printing never makes a
+ * worker wait for the terminal; the main thread calls dag::flush_log() before
+ * printing its summaries.
+ *
+ * The same shape, at a tenth of the cost, is also kept as a graph file
+ * (graphs/request_pipeline.dag, or the path given as the first argument):
+ * the demo compiles it to the binary form, maps it and runs the TaskGraph it
+ * describes, so the topology can change without rebuilding the demo.
+ *
  * Future-Proof Architecture:
  * - Tasks can return any type (double, string, complex objects, etc.)
  * - Type-safe result handling with std::variant and templates
  * - Flexible TaskResult that can hold different data types
  * - Clean interfaces that adapt to different result types
  * - Production-ready with excellent extensibility
+ * - Constant per-task metadata lives in a registry; results only carry a value
+ *   and a handle to their task's metadata
  */
 
+// ===== STATIC TASK METADATA =====
+
+// Everything about a task that does not change between executions
+struct TaskMetadata {
+    std::string name;
+    std::string description;
+    std::string source_info;
+    std::type_index result_type;
+};
+
+// Process-wide registry of task metadata. Entries are registered once per task
+// type and never move, so results can keep a plain pointer to them.
+class TaskMetadataRegistry {
+private:
+    mutable std::mutex mutex_;
+    std::deque<TaskMetadata> entries_;
+
+public:
+    static TaskMetadataRegistry& instance() {
+        static TaskMetadataRegistry registry;
+        return registry;
+    }
+
+    template<typename T>
+    const TaskMetadata& register_task(const std::string& name, const std::string& description,
+                                      const std::string& source_info) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.push_back(TaskMetadata{name, description, source_info, std::type_index(typeid(T))});
+        return entries_.back();
+    }
+
+    const TaskMetadata* find(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : entries_) {
+            if (entry.name == name) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+};
+
 // ===== FLEXIBLE RESULT TYPES =====
 
 // Base interface for type-erased results
 class ITaskResult {
 public:
     virtual ~ITaskResult() = default;
-    virtual std::string get_description() const = 0;
-    virtual std::string get_source_info() const = 0;
+    virtual const TaskMetadata& get_metadata() const = 0;
+    virtual const std::string& get_description() const = 0;
+    virtual const std::string& get_source_info() const = 0;
     virtual std::string get_type_name() const = 0;
     virtual std::string to_string() const = 0;
 };
@@ -53,19 +130,19 @@ template<typename T>
 class TaskResult : public ITaskResult {
 private:
     T value_;
-    std::string description_;
-    std::string source_info_;
+    const TaskMetadata* metadata_;
 
 public:
-    TaskResult(T value, const std::string& desc, const std::string& info = "")
-        : value_(std::move(value)), description_(desc), source_info_(info) {}
+    TaskResult(T value, const TaskMetadata& metadata)
+        : value_(std::move(value)), metadata_(&metadata) {}
 
     const T& get_value() const { return value_; }
     T& get_value() { return value_; }
 
-    std::string get_description() const override { return description_; }
-    std::string get_source_info() const override { return source_info_; }
-    std::string get_type_name() const override { return typeid(T).name(); }
+    const TaskMetadata& get_metadata() const override { return *metadata_; }
+    const std::string& get_description() const override { return metadata_->description; }
+    const std::string& get_source_info() const override { return metadata_->source_info; }
+    std::string get_type_name() const override { return metadata_->result_type.name(); }
 
     std::string to_string() const override {
         if constexpr (std::is_arithmetic_v<T>) {
@@ -83,58 +160,71 @@ using DoubleResult = TaskResult<double>;
 using StringResult = TaskResult<std::string>;
 using IntResult = TaskResult<int>;
 
-// Variant for storing different result types
+// Variant for storing different result types. Results are held by value so
+// they live directly in the executor's result arena (no per-task heap node).
 using AnyTaskResult = std::variant<
-    std::shared_ptr<DoubleResult>,
-    std::shared_ptr<StringResult>,
-    std::shared_ptr<IntResult>
+    DoubleResult,
+    StringResult,
+    IntResult
 >;
 
 // Helper function to create results
 template<typename T>
-std::shared_ptr<TaskResult<T>> make_task_result(T value, const std::string& desc, const std::string& info = "") {
-    return std::make_shared<TaskResult<T>>(std::move(value), desc, info);
+TaskResult<T> make_task_result(T value, const TaskMetadata& metadata) {
+    return TaskResult<T>(std::move(value), metadata);
 }
 
-// ===== LEVEL RESULT CONTAINERS =====
-
-struct Level1Results {
-    AnyTaskResult task1_result;
-    AnyTaskResult task2_result;
-    AnyTaskResult task3_result;
-
-    Level1Results() = default;
-    Level1Results(AnyTaskResult r1, AnyTaskResult r2, AnyTaskResult r3)
-        : task1_result(std::move(r1)), task2_result(std::move(r2)), task3_result(std::move(r3)) {}
-};
-
-struct Level2Results {
-    AnyTaskResult task4_result;
-    AnyTaskResult task5_result;
-
-    Level2Results() = default;
-    Level2Results(AnyTaskResult r4, AnyTaskResult r5)
-        : task4_result(std::move(r4)), task5_result(std::move(r5)) {}
-};
+// Values of a task's dependencies, in the order they were declared
+using TaskInputs = dag::NodeInputs<AnyTaskResult>;
 
 // ===== RESULT ACCESSOR HELPERS =====
 
 template<typename T>
-std::shared_ptr<TaskResult<T>> get_result_as(const AnyTaskResult& result) {
-    return std::get<std::shared_ptr<TaskResult<T>>>(result);
+const TaskResult<T>& get_result_as(const AnyTaskResult& result) {
+    return std::get<TaskResult<T>>(result);
+}
+
+// Borrows the value: no copy, valid while the consuming task runs
+template<typename T>
+const T& get_value_as(const AnyTaskResult& result) {
+    return get_result_as<T>(result).get_value();
 }
 
+// Takes ownership of input `index`: moved out of the arena if this task is its
+// last consumer and the executor releases consumed results, copied otherwise
 template<typename T>
-T get_value_as(const AnyTaskResult& result) {
-    return get_result_as<T>(result)->get_value();
+T take_value_as(const TaskInputs& inputs, std::size_t index) {
+    AnyTaskResult taken = inputs.take(index);
+    return std::move(std::get<TaskResult<T>>(taken).get_value());
 }
 
-std::shared_ptr<ITaskResult> get_result_interface(const AnyTaskResult& result) {
-    return std::visit([](auto&& arg) -> std::shared_ptr<ITaskResult> {
-        return std::static_pointer_cast<ITaskResult>(arg);
+const ITaskResult& get_result_interface(const AnyTaskResult& result) {
+    return std::visit([](const auto& arg) -> const ITaskResult& {
+        return arg;
     }, result);
 }
 
+// Cache options for AnyTaskResult: results are hashed by value (the metadata
+// handle is implied by the task name in the cache key)
+dag::CacheOptions<AnyTaskResult> make_result_cache_options(std::size_t memory_budget) {
+    dag::CacheOptions<AnyTaskResult> options;
+    options.memory_budget = memory_budget;
+    options.hash_value = [](const AnyTaskResult& result) {
+        return std::visit([](const auto& arg) {
+            using T = std::decay_t<decltype(arg.get_value())>;
+            return std::hash<T>{}(arg.get_value());
+        }, result);
+    };
+    options.value_bytes = [](const AnyTaskResult& result) {
+        std::size_t heap_bytes = 0;
+        if (const auto* str = std::get_if<StringResult>(&result)) {
+            heap_bytes = str->get_value().capacity();
+        }
+        return sizeof(AnyTaskResult) + heap_bytes;
+    };
+    return options;
+}
+
 // ===== EXCEPTION TYPES =====
 
 class TaskExecutionError : public std::runtime_error {
@@ -149,17 +239,39 @@ private:
     std::string task_name_;
 };
 
+// A data source that is briefly unavailable; worth retrying
+class TransientSourceError : public std::runtime_error {
+public:
+    explicit TransientSourceError(const std::string& task_name)
+        : std::runtime_error("Task " + task_name + ": data source temporarily unavailable") {}
+};
+
 // ===== TASK INTERFACE =====
 
+// Each task exposes its work twice: execute() for the runtime graph (values
+// travel as AnyTaskResult) and a static, strongly typed compute() that the
+// compile-time TypedGraph calls directly.
 class ITask {
 public:
     virtual ~ITask() = default;
-    virtual AnyTaskResult execute() = 0;
+    virtual AnyTaskResult execute(const TaskInputs& inputs) = 0;
     virtual std::string get_name() const = 0;
 
+    // Milliseconds of simulated I/O before the task can compute its result
+    virtual int io_wait_ms() const = 0;
+
+    // Runtime-graph entry point: waits out the task's I/O without holding a
+    // worker, then runs execute() on the thread that completed the wait
+    unifex::any_sender_of<AnyTaskResult> execute_async(const TaskInputs& inputs, int extra_wait_ms = 0) {
+        return simulate_work(io_wait_ms() + extra_wait_ms)
+            | unifex::then([this, &inputs]() { return execute(inputs); });
+    }
+
 protected:
-    void simulate_work(int duration_ms) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+    // Simulated I/O on the shared timer queue; completes with done as soon as
+    // the pipeline is stopped (the executor hands delay() the node's stop token)
+    static dag::DelaySender simulate_work(int duration_ms) {
+        return dag::delay(std::chrono::milliseconds(duration_ms));
     }
 };
 
@@ -167,18 +279,28 @@ protected:
 
 class Task1 : public ITask {
 public:
-    AnyTaskResult execute() override {
-        std::cout << "  [Task1] Processing data source A on thread: " << std::this_thread::get_id() << std::endl;
-        simulate_work(100);
+    AnyTaskResult execute(const TaskInputs&) override {
+        return make_task_result(compute(), metadata());
+    }
+
+    std::string get_name() const override { return metadata().name; }
+    int io_wait_ms() const override { return kIoWaitMs; }
+
+    static constexpr int kIoWaitMs = 100;
 
-        double result = process_data_source_a();
-        return make_task_result(result, "DataSourceA", "Primary data repository");
+    static const TaskMetadata& metadata() {
+        static const TaskMetadata& meta =
+            TaskMetadataRegistry::instance().register_task<double>("Task1", "DataSourceA", "Primary data repository");
+        return meta;
     }
 
-    std::string get_name() const override { return "Task1"; }
+    static double compute() {
+        dag::log_line("  [Task1] Processing data source A on thread: ", std::this_thread::get_id());
+        return process_data_source_a();
+    }
 
 private:
-    double process_data_source_a() {
+    static double process_data_source_a() {
         // Real data processing that returns numeric data
         return 42.5;
     }
@@ -186,37 +308,57 @@ private:
 
 class Task2 : public ITask {
 public:
-    AnyTaskResult execute() override {
-        std::cout << "  [Task2] Processing data source B on thread: " << std::this_thread::get_id() << std::endl;
-        simulate_work(80);
+    AnyTaskResult execute(const TaskInputs&) override {
+        return make_task_result(compute(), metadata());
+    }
+
+    std::string get_name() const override { return metadata().name; }
+    int io_wait_ms() const override { return kIoWaitMs; }
+
+    static constexpr int kIoWaitMs = 80;
 
-        std::string result = process_data_source_b();
-        return make_task_result(result, "DataSourceB", "Secondary data warehouse");
+    static const TaskMetadata& metadata() {
+        static const TaskMetadata& meta =
+            TaskMetadataRegistry::instance().register_task<std::string>("Task2", "DataSourceB", "Secondary data warehouse");
+        return meta;
     }
 
-    std::string get_name() const override { return "Task2"; }
+    static std::string compute() {
+        dag::log_line("  [Task2] Processing data source B on thread: ", std::this_thread::get_id());
+        return process_data_source_b();
+    }
 
-    private:
-        std::string process_data_source_b() {
-            // Real data processing that returns string data
-            return "PROCESSED_DATA_B_73.2";
-        }
+private:
+    static std::string process_data_source_b() {
+        // Real data processing that returns string data
+        return "PROCESSED_DATA_B_73.2";
+    }
 };
 
 class Task3 : public ITask {
 public:
-    AnyTaskResult execute() override {
-        std::cout << "  [Task3] Processing data source C on thread: " << std::this_thread::get_id() << std::endl;
-        simulate_work(120);
+    AnyTaskResult execute(const TaskInputs&) override {
+        return make_task_result(compute(), metadata());
+    }
 
-        int result = process_data_source_c();
-        return make_task_result(result, "DataSourceC", "External API endpoint");
+    std::string get_name() const override { return metadata().name; }
+    int io_wait_ms() const override { return kIoWaitMs; }
+
+    static constexpr int kIoWaitMs = 120;
+
+    static const TaskMetadata& metadata() {
+        static const TaskMetadata& meta =
+            TaskMetadataRegistry::instance().register_task<int>("Task3", "DataSourceC", "External API endpoint");
+        return meta;
     }
 
-    std::string get_name() const override { return "Task3"; }
+    static int compute() {
+        dag::log_line("  [Task3] Processing data source C on thread: ", std::this_thread::get_id());
+        return process_data_source_c();
+    }
 
 private:
-    int process_data_source_c() {
+    static int process_data_source_c() {
         // Real data processing that returns integer data
         return 91;
     }
@@ -224,22 +366,31 @@ private:
 
 // ===== LEVEL 2 TASKS (DEPENDENT) =====
 
+// Inputs: Task1 (double), Task2 (string)
 class Task4 : public ITask {
-private:
-    const Level1Results& level1_results_;
-
 public:
-    explicit Task4(const Level1Results& level1_results)
-        : level1_results_(level1_results) {}
+    AnyTaskResult execute(const TaskInputs& inputs) override {
+        // Extract values with type safety
+        double value1 = get_value_as<double>(inputs[0]);
+        const std::string& value2 = get_value_as<std::string>(inputs[1]);
 
-    AnyTaskResult execute() override {
-        std::cout << "  [Task4] Combining DataSourceA + DataSourceB on thread: " << std::this_thread::get_id() << std::endl;
-        simulate_work(60);
+        return make_task_result(compute(value1, value2), metadata());
+    }
 
-        // Extract values with type safety
-        double value1 = get_value_as<double>(level1_results_.task1_result);
-        std::string value2 = get_value_as<std::string>(level1_results_.task2_result);
+    std::string get_name() const override { return metadata().name; }
+    int io_wait_ms() const override { return kIoWaitMs; }
+
+    static constexpr int kIoWaitMs = 60;
 
+    static const TaskMetadata& metadata() {
+        static const TaskMetadata& meta =
+            TaskMetadataRegistry::instance().register_task<double>("Task4", "CombinedAB",
+                                                             "Merged DataSourceA(double) + DataSourceB(string->double)");
+        return meta;
+    }
+
+    static double compute(double value1, const std::string& value2) {
+        dag::log_line("  [Task4] Combining DataSourceA + DataSourceB on thread: ", std::this_thread::get_id());
         // Validate inputs
         if (value1 <= 0) {
             throw TaskExecutionError("Task4", "Invalid numeric input from Task1");
@@ -250,32 +401,36 @@ public:
 
         // Process: extract numeric part from string and combine
         double numeric_part = 73.2; // Extracted from string (simplified)
-        double combined_value = value1 + numeric_part;
-
-        return make_task_result(combined_value, "CombinedAB",
-                               "Merged DataSourceA(double) + DataSourceB(string->double)");
+        return value1 + numeric_part;
     }
-
-    std::string get_name() const override { return "Task4"; }
 };
 
+// Inputs: Task1 (double), Task2 (string), Task3 (int)
 class Task5 : public ITask {
-private:
-    const Level1Results& level1_results_;
-
 public:
-    explicit Task5(const Level1Results& level1_results)
-        : level1_results_(level1_results) {}
+    AnyTaskResult execute(const TaskInputs& inputs) override {
+        // Extract values with type safety
+        double value1 = get_value_as<double>(inputs[0]);
+        const std::string& value2 = get_value_as<std::string>(inputs[1]);
+        int value3 = get_value_as<int>(inputs[2]);
+
+        return make_task_result(compute(value1, value2, value3), metadata());
+    }
 
-    AnyTaskResult execute() override {
-        std::cout << "  [Task5] Aggregating all data sources on thread: " << std::this_thread::get_id() << std::endl;
-        simulate_work(90);
+    std::string get_name() const override { return metadata().name; }
+    int io_wait_ms() const override { return kIoWaitMs; }
 
-        // Extract values with type safety
-        double value1 = get_value_as<double>(level1_results_.task1_result);
-        std::string value2 = get_value_as<std::string>(level1_results_.task2_result);
-        int value3 = get_value_as<int>(level1_results_.task3_result);
+    static constexpr int kIoWaitMs = 90;
+
+    static const TaskMetadata& metadata() {
+        static const TaskMetadata& meta =
+            TaskMetadataRegistry::instance().register_task<double>("Task5", "AggregatedABC",
+                                                             "Average of double + string(->double) + int");
+        return meta;
+    }
 
+    static double compute(double value1, const std::string& value2, int value3) {
+        dag::log_line("  [Task5] Aggregating all data sources on thread: ", std::this_thread::get_id());
         // Validate inputs
         if (value1 <= 0 || value3 <= 0) {
             throw TaskExecutionError("Task5", "Invalid numeric inputs for aggregation");
@@ -286,91 +441,242 @@ public:
 
         // Process: compute average of all numeric values
         double numeric_from_string = 73.2; // Extracted from string (simplified)
-        double avg_value = (value1 + numeric_from_string + value3) / 3.0;
-
-        return make_task_result(avg_value, "AggregatedABC",
-                               "Average of double + string(->double) + int");
+        return (value1 + numeric_from_string + value3) / 3.0;
     }
-
-    std::string get_name() const override { return "Task5"; }
 };
 
 // ===== LEVEL 3 TASK (FINAL) =====
 
+// Inputs: Task4 (double), Task5 (double)
 class Task6 : public ITask {
-private:
-    const Level2Results& level2_results_;
-
 public:
-    explicit Task6(const Level2Results& level2_results)
-        : level2_results_(level2_results) {}
+    AnyTaskResult execute(const TaskInputs& inputs) override {
+        // Extract values with type safety
+        double value4 = get_value_as<double>(inputs[0]);
+        double value5 = get_value_as<double>(inputs[1]);
 
-    AnyTaskResult execute() override {
-        std::cout << "  [Task6] Final processing on thread: " << std::this_thread::get_id() << std::endl;
-        simulate_work(50);
+        return make_task_result(compute(value4, value5), metadata());
+    }
 
-        // Extract values with type safety
-        double value4 = get_value_as<double>(level2_results_.task4_result);
-        double value5 = get_value_as<double>(level2_results_.task5_result);
+    std::string get_name() const override { return metadata().name; }
+    int io_wait_ms() const override { return kIoWaitMs; }
+
+    static constexpr int kIoWaitMs = 50;
+
+    static const TaskMetadata& metadata() {
+        static const TaskMetadata& meta =
+            TaskMetadataRegistry::instance().register_task<double>("Task6", "FinalScore",
+                                                             "Weighted combination of Level 2 results");
+        return meta;
+    }
 
+    static double compute(double value4, double value5) {
+        dag::log_line("  [Task6] Final processing on thread: ", std::this_thread::get_id());
         // Validate inputs
         if (value4 <= 0 || value5 <= 0) {
             throw TaskExecutionError("Task6", "Invalid input values for final computation");
         }
 
         // Compute final weighted score
-        double final_score = (value4 * 0.6) + (value5 * 0.4);
-
-        return make_task_result(final_score, "FinalScore",
-                               "Weighted combination of Level 2 results");
+        return (value4 * 0.6) + (value5 * 0.4);
     }
-
-    std::string get_name() const override { return "Task6"; }
 };
 
 // ===== TASK DAG EXECUTOR =====
 
 class TaskDAGExecutor {
 private:
-    unifex::static_thread_pool& pool_;
+    dag::WorkStealingPool& pool_;
     std::chrono::steady_clock::time_point start_time_;
 
-    // Results storage
-    Level1Results level1_results_;
-    Level2Results level2_results_;
-    AnyTaskResult final_result_;
+    // Graph description and results of the last run (indexed by node id)
+    dag::TaskGraph<AnyTaskResult> graph_;
+    dag::GraphExecutor<AnyTaskResult> executor_{dag::ExecutorOptions{
+        dag::DispatchPolicy::CriticalPath, dag::ResultRetention::KeepAll, std::chrono::milliseconds(2000)}};
+
+    // Memoized results of the pure data-source tasks, shared across runs
+    dag::ResultCache<AnyTaskResult> cache_{make_result_cache_options(1024 * 1024)};
+
+    // Per-node enqueue/start/end timeline of every run
+    dag::TraceRecorder trace_;
+
+    // Per-node queue wait, run time and end-to-end latency across runs
+    dag::LatencyStats latencies_;
+
+    dag::NodeId task1_id_ = 0;
+    dag::NodeId task2_id_ = 0;
+    dag::NodeId task3_id_ = 0;
+    dag::NodeId task4_id_ = 0;
+    dag::NodeId task5_id_ = 0;
+    dag::NodeId task6_id_ = 0;
+
+    // Task made to throw TaskExecutionError, to demonstrate failure handling
+    std::string failing_task_;
+
+    // Task whose data source is made to hang, to demonstrate deadlines
+    std::string slow_task_;
+    int slow_task_delay_ms_ = 0;
+
+    // Task whose data source fails a few times before answering, to
+    // demonstrate retries
+    std::string flaky_task_;
+    std::atomic<int> flaky_failures_left_{0};
+
+    // Wraps a task so that its completion is reported as soon as it happens.
+    // Nodes are async: a task's simulated I/O holds no pool worker, and a
+    // stopped pipeline cancels the waits still pending.
+    dag::TaskGraph<AnyTaskResult>::AsyncTaskFn make_node_fn(std::shared_ptr<ITask> task) {
+        return [this, task](const TaskInputs& inputs) -> unifex::any_sender_of<AnyTaskResult> {
+            if (task->get_name() == failing_task_) {
+                throw TaskExecutionError(task->get_name(), "Injected failure");
+            }
+
+            if (task->get_name() == flaky_task_ && flaky_failures_left_.fetch_sub(1) > 0) {
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start_time_);
+                dag::log_line("  🔁 [", elapsed.count(), "ms] ", task->get_name(),
+                              ": data source unavailable, retrying after backoff");
+                throw TransientSourceError(task->get_name());
+            }
+
+            // A hanging data source is just a longer wait, cut short when the
+            // node is stopped (e.g. at its deadline)
+            const int stall_ms = task->get_name() == slow_task_ ? slow_task_delay_ms_ : 0;
+            return task->execute_async(inputs, stall_ms)
+                | unifex::then([this, task](AnyTaskResult result) {
+                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - start_time_);
+                    const auto& iface = get_result_interface(result);
+                    dag::log_line("  ✅ [", elapsed.count(), "ms] ", task->get_name(), ": ",
+                                  iface.get_description(), " = ", iface.to_string(), " (",
+                                  iface.get_type_name(), ")");
+                    return result;
+                });
+        };
+    }
 
-    template<typename... Ts>
-    auto unwrap_when_all(const std::tuple<Ts...>& when_all_result) {
-        return std::apply([](const auto&... variants) {
-            return std::make_tuple(std::get<0>(std::get<0>(variants))...);
-        }, when_all_result);
+    // Costs are the expected run times in ms; they drive critical-path priority
+    void build_graph() {
+        task1_id_ = graph_.add_async_node("Task1", {}, make_node_fn(std::make_shared<Task1>()), 100);
+        task2_id_ = graph_.add_async_node("Task2", {}, make_node_fn(std::make_shared<Task2>()), 80);
+        task3_id_ = graph_.add_async_node("Task3", {}, make_node_fn(std::make_shared<Task3>()), 120);
+
+        // Task3 calls an external API: never wait more than 200ms for it, fall
+        // back to the value it produced last time
+        graph_.set_timeout(task3_id_, std::chrono::milliseconds(200), dag::TimeoutPolicy::UseLastValue);
+
+        // Data sources are pure: identical invocations reuse the cached value
+        graph_.set_cacheable(task1_id_);
+        graph_.set_cacheable(task2_id_);
+        graph_.set_cacheable(task3_id_);
+
+        // Data sources can be briefly unavailable: retry those errors up to
+        // twice, 20ms then 40ms later (+-20%), without holding a worker
+        dag::RetryPolicy source_retry;
+        source_retry.max_attempts = 3;
+        source_retry.initial_backoff = std::chrono::milliseconds(20);
+        source_retry.retryable = dag::retry_on<TransientSourceError>();
+        graph_.set_retry(task1_id_, source_retry);
+        graph_.set_retry(task2_id_, source_retry);
+        graph_.set_retry(task3_id_, source_retry);
+
+        task4_id_ = graph_.add_async_node("Task4", {task1_id_, task2_id_},
+                                          make_node_fn(std::make_shared<Task4>()), 60);
+        task5_id_ = graph_.add_async_node("Task5", {task1_id_, task2_id_, task3_id_},
+                                          make_node_fn(std::make_shared<Task5>()), 90);
+
+        task6_id_ = graph_.add_async_node("Task6", {task4_id_, task5_id_},
+                                          make_node_fn(std::make_shared<Task6>()), 50);
     }
 
     void print_error_summary(const std::string& task_name, const std::exception& e) {
         auto error_time = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(error_time - start_time_);
 
+        dag::flush_log();
         std::cout << "\n💥 ERROR OCCURRED IN PIPELINE" << std::endl;
         std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
         std::cout << "❌ Failed Task: " << task_name << std::endl;
         std::cout << "🕐 Time of Failure: " << elapsed.count() << "ms after start" << std::endl;
         std::cout << "📋 Error Details: " << e.what() << std::endl;
-        std::cout << "🚫 Pipeline Status: TERMINATED - All subsequent tasks cancelled" << std::endl;
+        std::cout << "🚫 Pipeline Status: TERMINATED - Running tasks stopped, no further tasks dispatched" << std::endl;
         std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
     }
 
 public:
-    explicit TaskDAGExecutor(unifex::static_thread_pool& pool)
-        : pool_(pool) {}
+    explicit TaskDAGExecutor(dag::WorkStealingPool& pool, bool use_cache = true)
+        : pool_(pool) {
+        build_graph();
+        if (use_cache) {
+            executor_.set_cache(&cache_);
+        }
+        executor_.set_trace(&trace_);
+        executor_.set_latency_stats(&latencies_);
+    }
+
+    // p50/p99/p999 of every task over all runs so far, in ms
+    void print_latency_report() const {
+        const auto ms = [](std::uint64_t ns) { return static_cast<double>(ns) / 1e6; };
+        const auto percentiles = [&ms](const dag::LatencyHistogram& histogram) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(1) << ms(histogram.percentile(0.50)) << "/"
+                << ms(histogram.percentile(0.99)) << "/" << ms(histogram.percentile(0.999));
+            return out.str();
+        };
+
+        std::cout << "\n⏱️  Task latency over " << latencies_.runs()
+                  << " runs, p50/p99/p999 in ms:" << std::endl;
+        std::cout << "  " << std::left << std::setw(8) << "task" << std::right
+                  << std::setw(8) << "samples"
+                  << std::setw(20) << "queue wait"
+                  << std::setw(20) << "run time"
+                  << std::setw(20) << "end-to-end" << std::endl;
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+        for (dag::NodeId id = 0; id < graph_.size(); ++id) {
+            const auto& latency = latencies_.node(id);
+            std::cout << "  " << std::left << std::setw(8) << graph_.node(id).name << std::right
+                      << std::setw(8) << latency.end_to_end.count()
+                      << std::setw(20) << percentiles(latency.queue_wait)
+                      << std::setw(20) << percentiles(latency.run_time)
+                      << std::setw(20) << percentiles(latency.end_to_end) << std::endl;
+        }
+        std::cout << "💡 Cached tasks count towards end-to-end only; they never queue or run." << std::endl;
+    }
+
+    // Makes the named task fail on every following run ("" disables it)
+    void inject_failure(const std::string& task_name) { failing_task_ = task_name; }
+
+    // Makes the named task's data source hang for `delay_ms` ("" disables it)
+    void inject_delay(const std::string& task_name, int delay_ms) {
+        slow_task_ = task_name;
+        slow_task_delay_ms_ = delay_ms;
+    }
+
+    // Makes the named task's data source fail `count` times before it answers
+    void inject_transient_failures(const std::string& task_name, int count) {
+        flaky_task_ = task_name;
+        flaky_failures_left_ = count;
+    }
+
+    // Writes every run so far as Chrome trace-event JSON
+    void write_trace(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) {
+            throw std::runtime_error("Cannot open trace file: " + path);
+        }
+        trace_.write_chrome_trace(out, graph_);
+        std::cout << "\n📈 Trace of all runs written to " << path
+                  << " (open in chrome://tracing or ui.perfetto.dev)" << std::endl;
+    }
 
     void execute_pipeline() {
         start_time_ = std::chrono::steady_clock::now();
 
         try {
-            execute_level1();
-            execute_level2();
-            execute_level3();
+            std::cout << "🚀 Dispatching task graph (" << graph_.size()
+                      << " tasks, each starts as soon as its inputs are ready)" << std::endl;
+
+            executor_.run(graph_, pool_.get_scheduler());
             print_success_summary();
 
         } catch (const TaskExecutionError& e) {
@@ -382,171 +688,248 @@ public:
         }
     }
 
-private:
-    void execute_level1() {
-        std::cout << "🚀 Starting Level 1: Independent tasks (Task1, Task2, Task3)" << std::endl;
-
-        auto scheduler = pool_.get_scheduler();
-
-        // Create task instances
-        auto task1 = std::make_shared<Task1>();
-        auto task2 = std::make_shared<Task2>();
-        auto task3 = std::make_shared<Task3>();
-
-        // Execute tasks in parallel using unifex
-        auto task1_sender = unifex::schedule(scheduler) | unifex::then([task1]() {
-            return task1->execute();
-        });
-
-        auto task2_sender = unifex::schedule(scheduler) | unifex::then([task2]() {
-            return task2->execute();
-        });
-
-        auto task3_sender = unifex::schedule(scheduler) | unifex::then([task3]() {
-            return task3->execute();
-        });
-
-        // Wait for all Level 1 tasks
-        auto results = unifex::sync_wait(
-            unifex::when_all(
-                std::move(task1_sender),
-                std::move(task2_sender),
-                std::move(task3_sender)
-            )
-        );
-
-        if (!results.has_value()) {
-            throw std::runtime_error("Level 1 tasks were cancelled or completed with done signal");
-        }
+    // Re-executes only the named tasks and what depends on them, reusing the
+    // previous run's results for everything else
+    void refresh_tasks(const std::vector<std::string>& changed_tasks) {
+        start_time_ = std::chrono::steady_clock::now();
 
-        auto [result1, result2, result3] = unwrap_when_all(*results);
-        level1_results_ = Level1Results{result1, result2, result3};
-
-        std::cout << "✅ Level 1 completed successfully:" << std::endl;
-        auto r1_iface = get_result_interface(level1_results_.task1_result);
-        auto r2_iface = get_result_interface(level1_results_.task2_result);
-        auto r3_iface = get_result_interface(level1_results_.task3_result);
-
-        std::cout << "    Task1: " << r1_iface->get_description()
-                  << " = " << r1_iface->to_string()
-                  << " (" << r1_iface->get_type_name() << ")" << std::endl;
-        std::cout << "    Task2: " << r2_iface->get_description()
-                  << " = " << r2_iface->to_string()
-                  << " (" << r2_iface->get_type_name() << ")" << std::endl;
-        std::cout << "    Task3: " << r3_iface->get_description()
-                  << " = " << r3_iface->to_string()
-                  << " (" << r3_iface->get_type_name() << ")" << std::endl;
-    }
-
-    void execute_level2() {
-        std::cout << "\n🔄 Starting Level 2: Dependent tasks (Task4, Task5)" << std::endl;
-
-        auto scheduler = pool_.get_scheduler();
-
-        // Create task instances with Level 1 results
-        auto task4 = std::make_shared<Task4>(level1_results_);
-        auto task5 = std::make_shared<Task5>(level1_results_);
-
-        // Execute tasks in parallel
-        auto task4_sender = unifex::schedule(scheduler) | unifex::then([task4]() {
-            return task4->execute();
-        });
-
-        auto task5_sender = unifex::schedule(scheduler) | unifex::then([task5]() {
-            return task5->execute();
-        });
-
-        // Wait for all Level 2 tasks
-        auto results = unifex::sync_wait(
-            unifex::when_all(
-                std::move(task4_sender),
-                std::move(task5_sender)
-            )
-        );
-
-        if (!results.has_value()) {
-            throw std::runtime_error("Level 2 tasks were cancelled or completed with done signal");
+        for (const auto& name : changed_tasks) {
+            executor_.invalidate(find_task(name));
         }
 
-        auto [result4, result5] = unwrap_when_all(*results);
-        level2_results_ = Level2Results{result4, result5};
+        try {
+            std::cout << "♻️  Refreshing changed tasks and their dependents only" << std::endl;
 
-        std::cout << "✅ Level 2 completed successfully:" << std::endl;
-        auto r4_iface = get_result_interface(level2_results_.task4_result);
-        auto r5_iface = get_result_interface(level2_results_.task5_result);
+            executor_.run_incremental(graph_, pool_.get_scheduler());
+            print_success_summary();
 
-        std::cout << "    Task4: " << r4_iface->get_description()
-                  << " = " << std::fixed << std::setprecision(2) << r4_iface->to_string() << std::endl;
-        std::cout << "    Task5: " << r5_iface->get_description()
-                  << " = " << r5_iface->to_string() << std::endl;
+        } catch (const TaskExecutionError& e) {
+            print_error_summary(e.get_task_name(), e);
+            throw;
+        } catch (const std::exception& e) {
+            print_error_summary("Unknown", e);
+            throw;
+        }
     }
 
-    void execute_level3() {
-        std::cout << "\n🎯 Starting Level 3: Final task (Task6)" << std::endl;
-
-        auto scheduler = pool_.get_scheduler();
-
-        // Create final task instance
-        auto task6 = std::make_shared<Task6>(level2_results_);
-
-        // Execute final task
-        auto result = unifex::sync_wait(
-            unifex::schedule(scheduler) | unifex::then([task6]() {
-                return task6->execute();
-            })
-        );
-
-        if (!result.has_value()) {
-            throw std::runtime_error("Level 3 task was cancelled or completed with done signal");
+private:
+    dag::NodeId find_task(const std::string& name) const {
+        for (dag::NodeId id = 0; id < graph_.size(); ++id) {
+            if (graph_.node(id).name == name) {
+                return id;
+            }
         }
-
-        final_result_ = *result;
-
-        std::cout << "✅ Level 3 completed successfully:" << std::endl;
-        auto final_iface = get_result_interface(final_result_);
-        std::cout << "    Task6: " << final_iface->get_description()
-                  << " = " << std::fixed << std::setprecision(2) << final_iface->to_string() << std::endl;
+        throw std::invalid_argument("Unknown task: " + name);
     }
 
     void print_success_summary() {
         auto end_time = std::chrono::steady_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time_);
 
+        dag::flush_log();
         std::cout << "\n🎉 PIPELINE COMPLETED SUCCESSFULLY!" << std::endl;
         std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
         std::cout << "📊 Final Results (with types):" << std::endl;
 
-        auto r1 = get_result_interface(level1_results_.task1_result);
-        auto r2 = get_result_interface(level1_results_.task2_result);
-        auto r3 = get_result_interface(level1_results_.task3_result);
-        auto r4 = get_result_interface(level2_results_.task4_result);
-        auto r5 = get_result_interface(level2_results_.task5_result);
-        auto r6 = get_result_interface(final_result_);
-
-        std::cout << "  Level 1: Task1=" << r1->to_string() << " (double), "
-                  << "Task2=" << r2->to_string() << " (string), "
-                  << "Task3=" << r3->to_string() << " (int)" << std::endl;
-        std::cout << "  Level 2: Task4=" << std::fixed << std::setprecision(2) << r4->to_string() << " (double), "
-                  << "Task5=" << r5->to_string() << " (double)" << std::endl;
-        std::cout << "  Level 3: Task6=" << r6->to_string() << " (final weighted score)" << std::endl;
+        const auto& results = executor_.results();
+        const auto& r1 = get_result_interface(results.at(task1_id_));
+        const auto& r2 = get_result_interface(results.at(task2_id_));
+        const auto& r3 = get_result_interface(results.at(task3_id_));
+        const auto& r4 = get_result_interface(results.at(task4_id_));
+        const auto& r5 = get_result_interface(results.at(task5_id_));
+        const auto& r6 = get_result_interface(results.at(task6_id_));
+
+        std::cout << "  Level 1: Task1=" << r1.to_string() << " (double), "
+                  << "Task2=" << r2.to_string() << " (string), "
+                  << "Task3=" << r3.to_string() << " (int)" << std::endl;
+        std::cout << "  Level 2: Task4=" << std::fixed << std::setprecision(2) << r4.to_string() << " (double), "
+                  << "Task5=" << r5.to_string() << " (double)" << std::endl;
+        std::cout << "  Level 3: Task6=" << r6.to_string() << " (final weighted score)" << std::endl;
         std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
         std::cout << "🕐 Total Execution Time: " << duration.count() << "ms" << std::endl;
-        std::cout << "🎯 Final Result: " << std::fixed << std::setprecision(2) << r6->to_string() << std::endl;
+        std::cout << "⚙️  Tasks executed: " << executor_.last_run_size() << " of " << graph_.size() << std::endl;
+        if (executor_.cache() != nullptr) {
+            const auto stats = cache_.stats();
+            std::cout << "💾 Result cache: " << stats.hits << " hits, " << stats.misses << " misses, "
+                      << stats.entries << " entries (" << stats.bytes_used << " bytes)" << std::endl;
+        }
+        std::cout << "📇 Task metadata: " << TaskMetadataRegistry::instance().size()
+                  << " registered task types, results are " << sizeof(DoubleResult)
+                  << " bytes (value + metadata handle)" << std::endl;
+        std::cout << "🎯 Final Result: " << std::fixed << std::setprecision(2) << r6.to_string() << std::endl;
     }
 };
 
+// ===== COMPILE-TIME TYPED PIPELINE =====
+
+// Like ITask::execute_async(): the simulated I/O is a timer, not a blocked
+// worker, and compute() runs on the thread that completes the wait. The
+// inputs live in the lowered sender's operation until the graph completes.
+template<typename Task, typename Compute>
+auto with_async_io(Compute compute) {
+    return [compute](const auto&... inputs) {
+        return dag::delay(std::chrono::milliseconds(Task::kIoWaitMs))
+            | unifex::then([compute, &inputs...]() { return compute(inputs...); });
+    };
+}
+
+// Same graph as TaskDAGExecutor, but every edge type is checked by the compiler
+// and the whole graph is lowered into one sender with a single sync_wait.
+void execute_typed_pipeline(dag::WorkStealingPool& pool) {
+    std::cout << "\n🧩 Starting compile-time typed pipeline (one sender, one sync_wait)" << std::endl;
+    auto start_time = std::chrono::steady_clock::now();
+
+    const auto typed_graph = dag::make_typed_graph(
+        dag::typed_async_node<>(with_async_io<Task1>(&Task1::compute)),         // 0: double
+        dag::typed_async_node<>(with_async_io<Task2>(&Task2::compute)),         // 1: std::string
+        dag::typed_async_node<>(with_async_io<Task3>(&Task3::compute)),         // 2: int
+        dag::typed_async_node<0, 1>(with_async_io<Task4>(&Task4::compute)),     // 3: double
+        dag::typed_async_node<0, 1, 2>(with_async_io<Task5>(&Task5::compute)),  // 4: double
+        dag::typed_async_node<3, 4>(with_async_io<Task6>(&Task6::compute)));    // 5: double
+
+    auto results = unifex::sync_wait(typed_graph.lower(pool.get_scheduler()));
+    if (!results.has_value()) {
+        throw std::runtime_error("Typed pipeline was cancelled or completed with done signal");
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_time);
+
+    const auto& [value1, value2, value3, value4, value5, final_score] = *results;
+    dag::flush_log();
+    std::cout << "✅ Typed pipeline completed in " << duration.count() << "ms" << std::endl;
+    std::cout << "  Level 1: Task1=" << value1 << " (double), Task2=" << value2
+              << " (string), Task3=" << value3 << " (int)" << std::endl;
+    std::cout << "  Level 2: Task4=" << std::fixed << std::setprecision(2) << value4
+              << " (double), Task5=" << value5 << " (double)" << std::endl;
+    std::cout << "  Level 3: Task6=" << final_score << " (final weighted score)" << std::endl;
+}
+
+// ===== PIPELINE FROM A GRAPH FILE =====
+
+// Builds the graph a mapped file describes. load_task_graph() only makes
+// synchronous nodes; a "sleep" node here waits on delay() instead, like the
+// tasks above, so it does not hold a worker.
+dag::TaskGraph<int> build_file_graph(const dag::GraphFile& file) {
+    dag::TaskGraph<int> graph;
+    graph.reserve(file.size());
+    for (dag::NodeId id = 0; id < file.size(); ++id) {
+        const dag::GraphFile::NodeView node = file.node(id);
+        const auto preds = file.predecessors(id);
+        std::vector<dag::NodeId> predecessors(preds.first, preds.second);
+        auto sum = [](const dag::NodeInputs<int>& inputs) {
+            int total = 0;
+            for (std::size_t i = 0; i < inputs.size(); ++i) {
+                total += inputs[i];
+            }
+            return total;
+        };
+
+        if (node.kind == "sleep") {
+            const auto wait = std::chrono::milliseconds(static_cast<long>(node.param));
+            graph.add_async_node(std::string(node.name), std::move(predecessors),
+                [wait, sum](const dag::NodeInputs<int>& inputs) -> unifex::any_sender_of<int> {
+                    const int total = sum(inputs);
+                    return dag::delay(wait) | unifex::then([total]() { return total + 1; });
+                }, node.cost);
+        } else if (node.kind == "glue") {
+            graph.add_node(std::string(node.name), std::move(predecessors), sum, node.cost);
+        } else {
+            throw dag::GraphFileError(file.path(), "the demo has no node kind named " + std::string(node.kind));
+        }
+    }
+    return graph;
+}
+
+void execute_file_pipeline(dag::WorkStealingPool& pool, const std::string& path) {
+    std::cout << "\n📄 Starting pipeline loaded from " << path << std::endl;
+    const std::string binary = (std::filesystem::temp_directory_path() / "task_dag_demo.dagb").string();
+    try {
+        dag::write_graph_file(dag::parse_graph_text_file(path), binary, path);
+    } catch (const dag::GraphFileError& e) {
+        // Run from outside the repository, say: the rest of the demo stands
+        std::cout << "⚠️  Skipped: " << e.what() << std::endl;
+        return;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    dag::TaskGraph<int> graph;
+    std::size_t edges = 0;
+    {
+        const dag::GraphFile file(binary);
+        graph = build_file_graph(file);
+        edges = file.edge_count();
+    }
+    std::filesystem::remove(binary);
+    auto loaded = std::chrono::steady_clock::now();
+
+    dag::GraphExecutor<int> executor;
+    const auto& results = executor.run(graph, pool.get_scheduler());
+    auto finished = std::chrono::steady_clock::now();
+
+    std::cout << "✅ " << graph.size() << " nodes, " << edges << " edges; compiled, mapped and built in "
+              << std::fixed << std::setprecision(2)
+              << std::chrono::duration<double, std::milli>(loaded - start_time).count() << "ms, ran in "
+              << std::chrono::duration<double, std::milli>(finished - loaded).count() << "ms" << std::endl;
+    const dag::NodeId last = static_cast<dag::NodeId>(graph.size() - 1);
+    std::cout << "  " << graph.node(last).name << " = " << results[last]
+              << " (each sleep node adds 1 to the sum of its inputs)" << std::endl;
+}
+
 // ===== MAIN FUNCTION =====
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "=== UNIFEX TASK DAG - FLEXIBLE TYPE-SAFE ARCHITECTURE ===" << std::endl;
     std::cout << "Demonstrating tasks with different return types (double, string, int)\n" << std::endl;
 
-    unifex::static_thread_pool pool{4};
+    // Drop-in for unifex::static_thread_pool: per-worker deques, and a task made
+    // ready by a finishing one runs next on the same worker
+    dag::WorkStealingPool pool{4};
 
     try {
         TaskDAGExecutor executor(pool);
         executor.execute_pipeline();
 
+        // Same sources again: Task1-Task3 come from the cache and are not dispatched
+        std::cout << "\n🔁 Re-running pipeline with unchanged data sources" << std::endl;
+        executor.execute_pipeline();
+
+        // DataSourceC changed: only Task3 -> Task5 -> Task6 are re-executed
+        std::cout << "\n🔄 DataSourceC changed, refreshing its downstream cone" << std::endl;
+        executor.refresh_tasks({"Task3"});
+
+        // DataSourceC hangs: Task3 is stopped at its 200ms deadline and its
+        // consumers proceed with the value it produced last time
+        std::cout << "\n🐢 DataSourceC stalls for 1s, Task3 has a 200ms deadline" << std::endl;
+        executor.inject_delay("Task3", 1000);
+        executor.refresh_tasks({"Task3"});
+        executor.inject_delay("", 0);
+
+        // DataSourceB drops two requests: Task2 is retried with backoff and
+        // the run succeeds without anything else noticing
+        std::cout << "\n📶 DataSourceB fails twice before answering, Task2 retries" << std::endl;
+        executor.inject_transient_failures("Task2", 2);
+        executor.refresh_tasks({"Task2"});
+        executor.inject_transient_failures("", 0);
+
+        executor.print_latency_report();
+        executor.write_trace("task_dag_trace.json");
+
+        // Task4 fails right away: its sibling Task5 is stopped mid-run
+        // instead of finishing work whose result can no longer be used
+        std::cout << "\n💣 Injecting a failure into Task4" << std::endl;
+        executor.inject_failure("Task4");
+        try {
+            executor.execute_pipeline();
+        } catch (const TaskExecutionError&) {
+            // Reported by print_error_summary()
+        }
+        executor.inject_failure("");
+
+        execute_typed_pipeline(pool);
+
+        execute_file_pipeline(pool, argc > 1 ? argv[1] : "graphs/request_pipeline.dag");
+
     } catch (const std::exception& e) {
         return 1;
     }
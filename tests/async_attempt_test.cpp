@@ -0,0 +1,85 @@
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <thread>
+#include <type_traits>
+#include <unifex/inline_scheduler.hpp>
+#include <unifex/just.hpp>
+#include <unifex/static_thread_pool.hpp>
+#include <dag/dag_executor.hpp>
+
+/*
+ * An async node's attempt - its inputs and operation - lives until both
+ * unifex::start() and the sender's completion have returned. A sender that
+ * completes inside start() on inline_scheduler must not have its operation
+ * freed under it, and one that completes on another thread while start() is
+ * still running must not let run() return before start() has.
+ */
+
+namespace {
+
+std::atomic<bool> start_returned{false};
+std::thread completer;
+
+// Completes on its own thread, then keeps start() busy for a while
+struct CompletesElsewhere {
+    template<template<typename...> class Variant, template<typename...> class Tuple>
+    using value_types = Variant<Tuple<int>>;
+
+    template<template<typename...> class Variant>
+    using error_types = Variant<std::exception_ptr>;
+
+    static constexpr bool sends_done = false;
+
+    template<typename Receiver>
+    struct operation {
+        Receiver receiver;
+
+        void start() noexcept {
+            completer = std::thread([this] { unifex::set_value(std::move(receiver), 7); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            start_returned.store(true);
+        }
+    };
+
+    template<typename Receiver>
+    operation<std::remove_cv_t<std::remove_reference_t<Receiver>>> connect(Receiver&& receiver) && {
+        return {std::forward<Receiver>(receiver)};
+    }
+};
+
+} // namespace
+
+int main() {
+    dag::TaskGraph<int> graph;
+    const dag::NodeId now = graph.add_async_node("now", {}, [](const dag::NodeInputs<int>&) {
+        return unifex::just(5);
+    });
+    const dag::NodeId later = graph.add_node("later", {now}, [](const dag::NodeInputs<int>& in) { return in[0] + 1; });
+
+    dag::GraphExecutor<int> executor;
+    for (int run = 0; run < 100; ++run) {
+        const auto& results = executor.run(graph, unifex::inline_scheduler{});
+        if (results[later] != 6) {
+            std::cerr << "❌ synchronous async node produced " << results[later] << std::endl;
+            return 1;
+        }
+    }
+
+    dag::TaskGraph<int> elsewhere;
+    const dag::NodeId remote = elsewhere.add_async_node("remote", {}, [](const dag::NodeInputs<int>&) {
+        return CompletesElsewhere{};
+    });
+    unifex::static_thread_pool pool{2};
+    const int value = executor.run(elsewhere, pool.get_scheduler())[remote];
+    const bool returned = start_returned.load();
+    completer.join();
+    if (value != 7 || !returned) {
+        std::cerr << "❌ run() returned " << value << (returned ? "" : " while start() was still running")
+                  << std::endl;
+        return 1;
+    }
+    std::cout << "✅ async attempts outlive both start() and their completion" << std::endl;
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <dag/async_log.hpp>
+
+/*
+ * A line logged from a local char buffer must print what the buffer held
+ * at the call, not what it holds when the drain thread gets to it. The
+ * drain thread has no polling interval: flush() returns only because the
+ * pushes themselves woke it, including one made after it went to sleep.
+ * A thread that logs to several AsyncLog instances, one after another or
+ * side by side, gets a ring in each.
+ */
+
+int main() {
+    std::ostringstream sink;
+    dag::AsyncLog log;
+    log.set_sink(sink);
+
+    // A const char array, as a literal is, but one that changes afterwards
+    char buffer[32];
+    const auto& view = buffer;
+    std::strcpy(buffer, "first");
+    log.line("buffer=", view);
+    std::strcpy(buffer, "overwritten");
+    log.flush();
+
+    // By now the drain thread has emptied every ring and is asleep
+    std::thread producer([&log] { log.line("from another thread ", 42); });
+    producer.join();
+    log.flush();
+
+    const std::string expected = "buffer=first\nfrom another thread 42\n";
+    if (sink.str() != expected) {
+        std::cerr << "❌ expected '" << expected << "', got '" << sink.str() << "'" << std::endl;
+        return 1;
+    }
+    // A thread that has logged to one AsyncLog gets a ring of its own in the
+    // next, even when the next is allocated where the first one was
+    std::optional<dag::AsyncLog> logs[2];
+    std::ostringstream sinks[2];
+    for (int i = 0; i < 2; ++i) {
+        logs[0].emplace();
+        logs[0]->set_sink(sinks[i]);
+        logs[0]->line("instance ", i);
+        logs[0]->flush();
+        logs[0].reset();
+    }
+    logs[1].emplace();
+    logs[1]->set_sink(sinks[0]);
+    logs[1]->line("instance 2");
+    logs[1]->flush();
+    if (sinks[0].str() != "instance 0\ninstance 2\n" || sinks[1].str() != "instance 1\n") {
+        std::cerr << "❌ second instances lost lines: '" << sinks[0].str() << "', '" << sinks[1].str() << "'"
+                  << std::endl;
+        return 1;
+    }
+    std::cout << "✅ logged buffers are copied, pushes wake the drain thread, instances do not share rings" << std::endl;
+    return 0;
+}
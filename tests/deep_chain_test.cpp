@@ -0,0 +1,52 @@
+#include <iostream>
+#include <string>
+#include <unifex/static_thread_pool.hpp>
+#include <dag/dag_executor.hpp>
+#include <dag/result_cache.hpp>
+
+/*
+ * A chain of inline nodes readied outside a job - here from run()'s caller -
+ * runs on that thread one node after another. Each node must not nest the
+ * next one's run on the stack: 100k of them would overflow it. Neither may
+ * a chain of cache hits, which complete where they are readied.
+ */
+
+int main() {
+    constexpr int kLength = 100000;
+    dag::TaskGraph<int> graph;
+    dag::NodeId previous = graph.add_node("link0", {}, [](const dag::NodeInputs<int>&) { return 0; });
+    graph.set_inline(previous);
+    for (int i = 1; i < kLength; ++i) {
+        previous = graph.add_node("link" + std::to_string(i), {previous},
+                                  [](const dag::NodeInputs<int>& in) { return in[0] + 1; });
+        graph.set_inline(previous);
+    }
+
+    dag::GraphExecutor<int> executor;
+    unifex::static_thread_pool pool{2};
+    const auto& results = executor.run(graph, pool.get_scheduler());
+    if (results[previous] != kLength - 1 || executor.last_run_inlined() != static_cast<std::size_t>(kLength)) {
+        std::cerr << "❌ inline chain ended at " << results[previous] << " with " << executor.last_run_inlined()
+                  << " nodes inlined" << std::endl;
+        return 1;
+    }
+    dag::TaskGraph<int> cached;
+    previous = cached.add_node("link0", {}, [](const dag::NodeInputs<int>&) { return 0; });
+    cached.set_cacheable(previous);
+    for (int i = 1; i < kLength; ++i) {
+        previous = cached.add_node("link" + std::to_string(i), {previous},
+                                   [](const dag::NodeInputs<int>& in) { return in[0] + 1; });
+        cached.set_cacheable(previous);
+    }
+    dag::ResultCache<int> cache;
+    executor.set_cache(&cache);
+    executor.run(cached, pool.get_scheduler());
+    const auto& hits = executor.run(cached, pool.get_scheduler());
+    if (hits[previous] != kLength - 1 || cache.stats().hits != static_cast<std::size_t>(kLength)) {
+        std::cerr << "❌ cached chain ended at " << hits[previous] << " with " << cache.stats().hits << " hits"
+                  << std::endl;
+        return 1;
+    }
+    std::cout << "✅ long inline and cache-hit chains run in a loop, not nested" << std::endl;
+    return 0;
+}
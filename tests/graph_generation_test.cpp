@@ -0,0 +1,44 @@
+#include <iostream>
+#include <optional>
+#include <unifex/inline_scheduler.hpp>
+#include <dag/dag_executor.hpp>
+
+/*
+ * An executor keys what it keeps from a graph's last run on the graph's
+ * generation, not its address. The second graph below is built in the
+ * storage of the first, with as many nodes: an incremental run of it must
+ * not take it for the first graph and reuse that graph's values. Adding a
+ * node to a graph that was already run likewise forces a full run.
+ */
+
+int main() {
+    dag::GraphExecutor<int> executor;
+    unifex::inline_scheduler scheduler;
+
+    std::optional<dag::TaskGraph<int>> graph;
+    graph.emplace();
+    const dag::NodeId a = graph->add_node("a", {}, [](const dag::NodeInputs<int>&) { return 1; });
+    graph->add_node("b", {a}, [](const dag::NodeInputs<int>& in) { return in[0] + 1; });
+    executor.run(*graph, scheduler);
+
+    // std::optional rebuilds in place: same address, same size
+    graph.emplace();
+    graph->add_node("c", {}, [](const dag::NodeInputs<int>&) { return 10; });
+    graph->add_node("d", {}, [](const dag::NodeInputs<int>&) { return 20; });
+    {
+        const auto& results = executor.run_incremental(*graph, scheduler);
+        if (results[0] != 10 || results[1] != 20) {
+            std::cerr << "❌ a new graph at the old one's address got the old values" << std::endl;
+            return 1;
+        }
+    }
+
+    graph->add_node("e", {0, 1}, [](const dag::NodeInputs<int>& in) { return in[0] + in[1]; });
+    const auto& results = executor.run_incremental(*graph, scheduler);
+    if (executor.last_run_size() != graph->size() || results[2] != 30) {
+        std::cerr << "❌ incremental run of a changed graph reused the old run" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ changed graphs are rebuilt, not served from stale caches" << std::endl;
+    return 0;
+}
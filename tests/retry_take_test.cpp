@@ -0,0 +1,54 @@
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unifex/static_thread_pool.hpp>
+#include <dag/dag_executor.hpp>
+
+/*
+ * A node with a RetryPolicy take()s its input under ReleaseConsumed and
+ * fails its first attempt. The retry must read the same value: take()
+ * copies for nodes that may be retried instead of moving the value out.
+ */
+
+int main() {
+    dag::TaskGraph<std::string> graph;
+    const dag::NodeId source = graph.add_node("source", {}, [](const dag::NodeInputs<std::string>&) {
+        return std::string(64, 'x');  // past the small-string buffer, so a move empties it
+    });
+
+    std::atomic<int> attempts{0};
+    const dag::NodeId consumer = graph.add_node("consumer", {source},
+        [&attempts](const dag::NodeInputs<std::string>& inputs) {
+            std::string value = inputs.take(0);
+            if (attempts.fetch_add(1) == 0) {
+                throw std::runtime_error("transient failure");
+            }
+            if (value != std::string(64, 'x')) {
+                throw std::logic_error("retry saw a moved-from input: '" + value + "'");
+            }
+            return value + "!";
+        });
+    dag::RetryPolicy retry;
+    retry.max_attempts = 3;
+    retry.initial_backoff = std::chrono::milliseconds(1);
+    graph.set_retry(consumer, retry);
+
+    dag::ExecutorOptions options;
+    options.retention = dag::ResultRetention::ReleaseConsumed;
+    dag::GraphExecutor<std::string> executor(options);
+    unifex::static_thread_pool pool{2};
+
+    try {
+        const auto& results = executor.run(graph, pool.get_scheduler());
+        if (attempts.load() != 2 || results[consumer] != std::string(64, 'x') + "!") {
+            std::cerr << "❌ unexpected result after " << attempts.load() << " attempts" << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "✅ retried node read its taken input intact" << std::endl;
+    return 0;
+}
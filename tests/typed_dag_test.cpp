@@ -0,0 +1,86 @@
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unifex/static_thread_pool.hpp>
+#include <unifex/sync_wait.hpp>
+#include <unifex/then.hpp>
+#include <dag/async_delay.hpp>
+#include <dag/typed_dag.hpp>
+
+/*
+ * The slow source waits until a node that depends only on the fast source
+ * has run. Lowered level by level, that node would wait for the slow source
+ * and the wait would time out; lowered per node, it runs right after the
+ * fast one. A void node orders its consumer without passing it a value, an
+ * async node's sender supplies its value, and a throwing node fails the
+ * whole sender.
+ */
+
+int main() {
+    unifex::static_thread_pool pool{2};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool after_fast_ran = false;
+    bool marked = false;
+
+    const auto graph = dag::make_typed_graph(
+        dag::typed_node<>([&]() {                                      // 0: slow
+            std::unique_lock<std::mutex> lock(mutex);
+            return cv.wait_for(lock, std::chrono::seconds(5), [&] { return after_fast_ran; });
+        }),
+        dag::typed_node<>([]() { return std::string("fast"); }),      // 1: fast
+        dag::typed_node<1>([&](const std::string& fast) {             // 2: after fast only
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                after_fast_ran = true;
+            }
+            cv.notify_all();
+            return fast.size();
+        }),
+        dag::typed_node<1>([&](const std::string&) { marked = true; }), // 3: void
+        dag::typed_node<0, 2, 3>([&](bool released, std::size_t length) { // 4: no argument from 3
+            return released && marked ? length : 0;
+        }));
+
+    auto results = unifex::sync_wait(graph.lower(pool.get_scheduler()));
+    if (!results || !std::get<0>(*results)) {
+        std::cerr << "❌ a node waited for a source it does not depend on" << std::endl;
+        return 1;
+    }
+    if (std::get<4>(*results) != 4) {
+        std::cerr << "❌ join saw " << std::get<4>(*results) << ", expected 4" << std::endl;
+        return 1;
+    }
+
+    const auto async = dag::make_typed_graph(
+        dag::typed_node<>([]() { return 2; }),
+        dag::typed_async_node<0>([](int factor) {
+            return dag::delay(std::chrono::milliseconds(10)) | unifex::then([factor]() { return factor * 21; });
+        }),
+        dag::typed_node<1>([](int value) { return value + 0.5; }));
+    auto async_results = unifex::sync_wait(async.lower(pool.get_scheduler()));
+    if (!async_results || std::get<1>(*async_results) != 42 || std::get<2>(*async_results) != 42.5) {
+        std::cerr << "❌ async node did not pass on its sender's value" << std::endl;
+        return 1;
+    }
+
+    const auto failing = dag::make_typed_graph(
+        dag::typed_node<>([]() -> int { throw std::runtime_error("boom"); }),
+        dag::typed_node<0>([](int value) { return value + 1; }));
+    try {
+        unifex::sync_wait(failing.lower(pool.get_scheduler()));
+        std::cerr << "❌ a throwing node did not fail the sender" << std::endl;
+        return 1;
+    } catch (const std::runtime_error& error) {
+        if (std::string(error.what()) != "boom") {
+            std::cerr << "❌ unexpected error: " << error.what() << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✅ typed nodes wait only for their own dependencies" << std::endl;
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include <algorithm>
+#include <iostream>
+#include <dag/graph_validation.hpp>
+
+/*
+ * Two sources, only one of them listed as a root. A node that joins both
+ * can never become ready - it waits for the unlisted source - so it is
+ * unreachable along with that source; a node after the listed root alone
+ * is fine.
+ */
+
+int main() {
+    dag::TaskGraph<int> graph;
+    const dag::NodeId listed = graph.add_node("listed", {}, nullptr);
+    const dag::NodeId unlisted = graph.add_node("unlisted", {}, nullptr);
+    const dag::NodeId after_listed = graph.add_node("after_listed", {listed}, nullptr);
+    const dag::NodeId join = graph.add_node("join", {listed, unlisted}, nullptr);
+    const dag::NodeId after_join = graph.add_node("after_join", {after_listed, join}, nullptr);
+
+    dag::ValidationOptions options;
+    options.roots = {listed};
+    const dag::GraphReport report = dag::validate_graph(graph, options);
+
+    const std::vector<dag::NodeId> expected = {unlisted, join, after_join};
+    if (report.unreachable != expected || report.unreachable_count != expected.size() || report.valid()) {
+        std::cerr << "❌ expected unlisted, join and after_join unreachable, got";
+        for (dag::NodeId id : report.unreachable) {
+            std::cerr << " " << graph.node(id).name;
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+    if (std::find(report.unreachable.begin(), report.unreachable.end(), after_listed) != report.unreachable.end()) {
+        std::cerr << "❌ after_listed wrongly reported unreachable" << std::endl;
+        return 1;
+    }
+
+    // With every source a root, the graph is fine
+    if (!dag::validate_graph(graph).valid()) {
+        std::cerr << "❌ graph invalid with the default roots" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ a node waiting on an unlisted root is unreachable" << std::endl;
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unifex/execute.hpp>
+#include <dag/work_stealing_pool.hpp>
+
+/*
+ * LIFO slot fairness of WorkStealingPool:
+ * - a task put in the empty LIFO slot of a worker that then blocks must be
+ *   picked up by another, parked worker - so filling the slot wakes one,
+ * - a task that keeps rescheduling itself through the slot of a lone worker
+ *   must not starve a task waiting in that worker's deque.
+ */
+
+namespace {
+
+bool wait_for(std::mutex& mutex, std::condition_variable& cv, const bool& flag) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cv.wait_for(lock, std::chrono::seconds(5), [&flag] { return flag; });
+}
+
+void set(std::mutex& mutex, std::condition_variable& cv, bool& flag) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        flag = true;
+    }
+    cv.notify_all();
+}
+
+bool slot_task_is_stolen() {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool ran = false;
+    bool blocked_done = false;
+    bool result = false;
+    dag::WorkStealingPool pool{2};  // joined before the above go away
+    auto scheduler = pool.get_scheduler();
+
+    unifex::execute(scheduler, [&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));  // let the other worker park
+        unifex::execute(scheduler, [&] { set(mutex, cv, ran); });
+        result = wait_for(mutex, cv, ran);  // the owner is busy: only a thief can run it
+        set(mutex, cv, blocked_done);
+    });
+    return wait_for(mutex, cv, blocked_done) && result;
+}
+
+bool deque_is_not_starved() {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> waiting_ran{false};
+    bool finished = false;
+    int spins = 0;
+    dag::WorkStealingPool pool{1};
+    auto scheduler = pool.get_scheduler();
+
+    std::function<void()> spin = [&] {
+        if (waiting_ran.load() || ++spins > 1000) {
+            set(mutex, cv, finished);
+            return;
+        }
+        unifex::execute(scheduler, spin);
+    };
+    unifex::execute(scheduler, [&] {
+        unifex::execute(scheduler, [&] { waiting_ran.store(true); });  // ends up in the deque
+        unifex::execute(scheduler, spin);
+    });
+    return wait_for(mutex, cv, finished) && waiting_ran.load() && spins < 1000;
+}
+
+} // namespace
+
+int main() {
+    if (!slot_task_is_stolen()) {
+        std::cerr << "❌ a task in a busy worker's LIFO slot was never run" << std::endl;
+        return 1;
+    }
+    if (!deque_is_not_starved()) {
+        std::cerr << "❌ a task rescheduling itself through the LIFO slot starved the deque" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ LIFO slot tasks wake thieves and cannot starve the deque" << std::endl;
+    return 0;
+}